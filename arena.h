@@ -0,0 +1,103 @@
+/**
+ * @file arena.h
+ *
+ * Bump allocator for many small objects with common lifetime.
+ *
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+	@brief Hands out memory from big blocks by bumping a pointer. Memory is only released as a whole, by \a release() or on destruction.
+	@details Objects created in the arena are never destroyed individually, so they are required to be trivially destructible.
+*/
+class arena {
+public:
+	/// @brief Counters describing the memory handed out by an arena.
+	struct statistics {
+		/// @brief Number of objects and arrays created since construction or last \a release().
+		std::size_t allocations;
+		/// @brief Number of blocks currently held.
+		std::size_t blocks;
+		/// @brief Number of bytes in all blocks currently held.
+		std::size_t bytes;
+	};
+
+	/// @brief Default size of a block in bytes.
+	static constexpr std::size_t default_block_size{ 1 << 20 };
+
+private:
+	std::vector<std::unique_ptr<char[]>> blocks;
+	char* current;
+	std::size_t remaining;
+	std::size_t block_size;
+	statistics counters;
+
+	/// @brief Returns memory of \a size bytes aligned to \a alignment (which must not exceed alignof(std::max_align_t)).
+	void* allocate(const std::size_t& size, const std::size_t& alignment) {
+		const std::size_t padding{ (alignment - reinterpret_cast<std::uintptr_t>(current) % alignment) % alignment };
+		if (current == nullptr || padding + size > remaining) {
+			// requests bigger than a block get their own block:
+			const std::size_t new_block_size{ std::max(block_size, size) };
+			blocks.emplace_back(new char[new_block_size]);
+			counters.bytes += new_block_size;
+			++counters.blocks;
+			current = blocks.back().get();
+			remaining = new_block_size;
+			return allocate(size, alignment);
+		}
+		void* result{ current + padding };
+		current += padding + size;
+		remaining -= padding + size;
+		++counters.allocations;
+		return result;
+	}
+
+public:
+	/// @brief Creates an empty arena. No memory is reserved until the first object is created.
+	explicit arena(const std::size_t& block_size = default_block_size) noexcept :
+		blocks(),
+		current(nullptr),
+		remaining(0),
+		block_size(block_size),
+		counters{ 0, 0, 0 }
+	{
+	}
+
+	arena(const arena&) = delete;
+	arena& operator=(const arena&) = delete;
+
+	/// @brief Constructs an object of type \a _T in the arena from \a args.
+	template<class _T, class... _Args>
+	_T* create(_Args&&... args) {
+		static_assert(std::is_trivially_destructible<_T>::value, "Objects in an arena are never destroyed.");
+		return new (allocate(sizeof(_T), alignof(_T))) _T(std::forward<_Args>(args)...);
+	}
+
+	/// @brief Constructs an array of \a n objects of type \a _T in the arena, each a copy of \a value.
+	template<class _T>
+	_T* create_array(const std::size_t& n, const _T& value) {
+		static_assert(std::is_trivially_destructible<_T>::value, "Objects in an arena are never destroyed.");
+		_T* result{ static_cast<_T*>(allocate(sizeof(_T) * n, alignof(_T))) };
+		for (std::size_t i{ 0 }; i < n; ++i) new (result + i) _T(value);
+		return result;
+	}
+
+	/// @brief Releases all memory at once. All objects created in the arena become invalid.
+	void release() noexcept {
+		decltype(blocks)().swap(blocks);
+		current = nullptr;
+		remaining = 0;
+		counters = statistics{ 0, 0, 0 };
+	}
+
+	/// @brief Returns counters about allocations and reserved memory.
+	const statistics& stats() const noexcept { return counters; }
+};
@@ -0,0 +1,82 @@
+/**
+ * @file binary_format.h
+ *
+ * Building blocks of the binary snapshot format for markov chains.
+ *
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+
+/**
+	@brief Layout constants and helpers of the binary snapshot format.
+	@details A snapshot consists of a \a header followed by sections, each padded to a multiple of 8 bytes:
+	row offsets (n_states + 1 values of std::uint64_t), columns (n_edges state ids), probabilities (n_edges values),
+	n_edge_decorations columns of n_edges edge decorations, n_node_decorations columns of n_states node decorations
+	and n_state_ids state ids (zero if the ids are 0, 1, ..., n_states-1, n_states otherwise).
+	The file ends with a \a checksum over all preceding 64-bit words. All values are stored in the byte order of the writing machine.
+*/
+class binary_format {
+public:
+	/// @brief First 8 bytes of each snapshot file.
+	inline static const char magic[8]{ 'M', 'C', 'A', 'B', 'I', 'N', '\0', '\0' };
+
+	/// @brief Current version of the format. Readers reject other versions.
+	static constexpr std::uint32_t version{ 2 };
+
+	/// @brief Written as is, to detect files written on a machine with different byte order.
+	static constexpr std::uint32_t byte_order_mark{ 0x01020304 };
+
+	/// @brief Fixed size header at the beginning of a snapshot file.
+	struct header {
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t byte_order_mark;
+		std::uint32_t size_integral;
+		std::uint32_t size_rational;
+		std::uint64_t n_states;
+		std::uint64_t n_edges;
+		std::uint64_t n_edge_decorations;
+		std::uint64_t n_node_decorations;
+		std::uint64_t n_state_ids;
+	};
+	static_assert(sizeof(header) % 8 == 0, "Header must keep sections 8-byte aligned.");
+
+	/// @brief Returns \a size rounded up to a multiple of 8.
+	static constexpr std::size_t padded(const std::size_t& size) { return (size + 7) / 8 * 8; }
+
+	/**
+		@brief 64-bit FNV-1a hash over 64-bit words.
+		@details Data must be fed in pieces whose sizes are multiples of 8 bytes, which holds for the header and all padded sections.
+	*/
+	class checksum {
+		std::uint64_t hash{ 0xcbf29ce484222325ull };
+
+	public:
+		void add(const char* data, const std::size_t& size) noexcept {
+			for (std::size_t pos{ 0 }; pos + 8 <= size; pos += 8) {
+				std::uint64_t word;
+				std::memcpy(&word, data + pos, 8);
+				hash = (hash ^ word) * 0x100000001b3ull;
+			}
+		}
+
+		std::uint64_t value() const noexcept { return hash; }
+	};
+
+	/// @brief Writes \a size bytes of \a data and zero padding up to the next multiple of 8 to \a output, and adds them to \a sum.
+	static void write_section(std::ostream& output, checksum& sum, const void* data, const std::size_t& size) {
+		static const char zeros[8]{};
+		output.write(static_cast<const char*>(data), size);
+		sum.add(static_cast<const char*>(data), size / 8 * 8);
+		const std::size_t rest{ size % 8 };
+		if (rest) {
+			char last_word[8]{};
+			std::memcpy(last_word, static_cast<const char*>(data) + size / 8 * 8, rest);
+			output.write(zeros, 8 - rest);
+			sum.add(last_word, 8);
+		}
+	}
+};
@@ -0,0 +1,130 @@
+/**
+ * @file bit_set.h
+ *
+ * Dense set of non-negative integers stored as bitset.
+ *
+ */
+#pragma once
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+/**
+	@brief Set of non-negative integers with one bit per possible element, e.g. a set of states.
+	@details Membership checks and insertions are a single bit operation, set algebra works on 64 elements per instruction.
+	Memory is proportional to the greatest element, not to the number of elements: 1 bit per integer from 0 up to the greatest element.
+	The set grows automatically when inserting elements beyond its current capacity.
+	@tparam _IntegerT type of the elements, an unsigned integral type
+*/
+template<class _IntegerT>
+class bit_set {
+public:
+	/// @brief Type of the elements.
+	using value_type = _IntegerT;
+
+private:
+	using word_type = std::uint64_t;
+	static constexpr std::size_t bits_per_word{ 64 };
+
+	/// @brief Bit i % 64 of words[i / 64] is set if and only if i is an element. All bits beyond words are zero.
+	std::vector<word_type> words;
+
+	static std::size_t word_index(const std::size_t& value) noexcept { return value / bits_per_word; }
+	static word_type bit_mask(const std::size_t& value) noexcept { return word_type(1) << (value % bits_per_word); }
+
+public:
+	/// @brief Creates an empty set.
+	bit_set() noexcept : words() {}
+
+	/// @brief Creates an empty set with capacity for all elements less than \a capacity.
+	explicit bit_set(const std::size_t& capacity) : words((capacity + bits_per_word - 1) / bits_per_word, 0) {}
+
+	/// @brief Creates the set { 0, 1, ..., \a n - 1 }.
+	static bit_set filled(const std::size_t& n) {
+		bit_set result(n);
+		std::fill(result.words.begin(), result.words.begin() + n / bits_per_word, ~word_type(0));
+		if (n % bits_per_word) result.words.back() = bit_mask(n) - 1;
+		return result;
+	}
+
+	/// @brief Makes room for all elements less than \a capacity.
+	void reserve(const std::size_t& capacity) {
+		const std::size_t n_words{ (capacity + bits_per_word - 1) / bits_per_word };
+		if (words.size() < n_words) words.resize(n_words, 0);
+	}
+
+	/// @brief Adds \a value to the set.
+	void insert(const _IntegerT& value) {
+		const std::size_t index{ word_index(static_cast<std::size_t>(value)) };
+		if (!(index < words.size())) words.resize(std::max(index + 1, 2 * words.size()), 0);
+		words[index] |= bit_mask(static_cast<std::size_t>(value));
+	}
+
+	/// @brief Removes \a value from the set.
+	void erase(const _IntegerT& value) noexcept {
+		const std::size_t index{ word_index(static_cast<std::size_t>(value)) };
+		if (index < words.size()) words[index] &= ~bit_mask(static_cast<std::size_t>(value));
+	}
+
+	/// @brief Returns 1 if \a value is an element, 0 otherwise.
+	std::size_t count(const _IntegerT& value) const noexcept {
+		const std::size_t index{ word_index(static_cast<std::size_t>(value)) };
+		return index < words.size() && (words[index] & bit_mask(static_cast<std::size_t>(value))) ? 1 : 0;
+	}
+
+	/// @brief Returns the number of elements. Runs over all words.
+	std::size_t size() const noexcept {
+		std::size_t result{ 0 };
+		for (const auto& word : words) result += std::bitset<bits_per_word>(word).count();
+		return result;
+	}
+
+	/// @brief Returns true if and only if there are no elements.
+	bool empty() const noexcept {
+		return std::all_of(words.cbegin(), words.cend(), [](const word_type& word) { return word == 0; });
+	}
+
+	/// @brief Calls \a callback(value) for each element in ascending order.
+	template<class _Callback>
+	void for_each(_Callback&& callback) const {
+		for (std::size_t index{ 0 }; index < words.size(); ++index) {
+			const word_type word{ words[index] };
+			if (!word) continue;
+			for (std::size_t bit{ 0 }; bit < bits_per_word; ++bit)
+				if (word & (word_type(1) << bit)) callback(static_cast<_IntegerT>(index * bits_per_word + bit));
+		}
+	}
+
+	/// @brief Adds all elements of \a other.
+	bit_set& operator|=(const bit_set& other) {
+		if (words.size() < other.words.size()) words.resize(other.words.size(), 0);
+		for (std::size_t index{ 0 }; index < other.words.size(); ++index) words[index] |= other.words[index];
+		return *this;
+	}
+
+	/// @brief Removes all elements that are not in \a other.
+	bit_set& operator&=(const bit_set& other) {
+		if (words.size() > other.words.size()) words.resize(other.words.size());
+		for (std::size_t index{ 0 }; index < words.size(); ++index) words[index] &= other.words[index];
+		return *this;
+	}
+
+	/// @brief Removes all elements of \a other.
+	bit_set& operator-=(const bit_set& other) {
+		const std::size_t n_words{ std::min(words.size(), other.words.size()) };
+		for (std::size_t index{ 0 }; index < n_words; ++index) words[index] &= ~other.words[index];
+		return *this;
+	}
+
+	/// @brief Returns true if and only if both sets contain the same elements.
+	bool operator==(const bit_set& other) const noexcept {
+		const auto& shorter{ words.size() < other.words.size() ? words : other.words };
+		const auto& longer{ words.size() < other.words.size() ? other.words : words };
+		return std::equal(shorter.cbegin(), shorter.cend(), longer.cbegin())
+			&& std::all_of(longer.cbegin() + shorter.size(), longer.cend(), [](const word_type& word) { return word == 0; });
+	}
+
+	bool operator!=(const bit_set& other) const noexcept { return !(*this == other); }
+};
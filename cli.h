@@ -27,6 +27,35 @@ public:
 };
 
 
+/**
+	@brief Reads solver parameters given as instruction parameters of the form {key}={value} into \a prm.
+	@exception failed_instruction Parameter is not of the form {key}={value}.
+	@exception failed_instruction Unknown solver engine.
+	@exception failed_instruction Unknown precision.
+*/
+template<class _Iterator>
+inline void parse_solver_parameters(_Iterator begin, _Iterator end, solver_parameters& prm) {
+	for (auto it = begin; it != end; ++it) {
+		const auto pos{ it->find('=') };
+		if (pos == std::string::npos) throw failed_instruction(std::string("Expected solver parameter of the form {key}={value}: ") + *it);
+		const auto key{ boost::trim_copy(it->substr(0, pos)) };
+		const auto value{ boost::trim_copy(it->substr(pos + 1)) };
+		if (key.empty()) throw failed_instruction(std::string("Expected solver parameter of the form {key}={value}: ") + *it);
+		prm.put(key, value);
+	}
+	if (!is_solver_engine(prm.get<std::string>("engine", default_solver_engine))) throw failed_instruction("Unknown solver engine: " + prm.get<std::string>("engine"));
+	const auto precision{ prm.get<std::string>("precision", "double") };
+	if (precision != "double" && precision != "single" && precision != "mixed") throw failed_instruction("Unknown precision: " + precision);
+}
+
+/**
+	@brief Returns the index of the first solver parameter in \a items, an instruction with \a n_fixed fixed items.
+	@details Skips the free transition decoration that calc_variance and calc_covariance needed in former versions, so that old instruction files still work.
+*/
+inline std::size_t first_solver_parameter(const std::vector<std::string>& items, const std::size_t& n_fixed) {
+	return items.size() > n_fixed && items[n_fixed].find('=') == std::string::npos ? n_fixed + 1 : n_fixed;
+}
+
 /**
 	@brief Reads commands from stream, performs corresponding actions.
 	@param commands stream containing commands, separated by new line ('\n'). Parameters are separated with '>' within one line.
@@ -85,6 +114,7 @@ inline nlohmann::json cli(std::istream& commands, global& g) {
 				}
 				catch (...) { throw failed_instruction("Could not parse parameter."); }
 				g.markov_chains[id] = std::make_unique<mc_type>(n_transition_decoration, n_state_decoration);
+				g.invalidate_solvers_of_mc(id);
 				performance_log.push_back({
 						{instruction,
 							{
@@ -98,7 +128,7 @@ inline nlohmann::json cli(std::istream& commands, global& g) {
 			}
 
 			if (instruction == cli_commands::READ_TRA) {
-				if (items.size() != 3) throw failed_instruction("Wrong number of parameters.");
+				if (items.size() != 3 && items.size() != 4) throw failed_instruction("Wrong number of parameters.");
 				std::string& file_path = items[2];
 				global::id id{ 0 };
 				std::ifstream file{};
@@ -106,15 +136,24 @@ inline nlohmann::json cli(std::istream& commands, global& g) {
 					id = std::stoull(items[1]);
 				}
 				catch (...) { throw failed_instruction("Could not parse parameter."); }
+				const bool strict{ items.size() == 4 };
+				if (strict && items[3] != sc::strict) throw failed_instruction("Could not parse parameter.");
 				file.open(file_path);
 				if (!file.good()) throw failed_instruction("Could not open file.");
+				file.close();
 				if (g.markov_chains[id] == nullptr) throw failed_instruction("No markov chain present with given ID.");
-				g.markov_chains[id]->read_transitions_from_prism_file(file);
+				g.invalidate_solvers_of_mc(id);
+				const auto time_begin{ std::chrono::steady_clock::now() };
+				g.markov_chains[id]->read_transitions_from_prism_file(file_path, strict);
+				const auto time_end{ std::chrono::steady_clock::now() };
 				performance_log.push_back({
 						{instruction,
 							{
 								{ sc::markov_chain_id, id},
-								{ sc::file_path, file_path}
+								{ sc::file_path, file_path},
+								{ sc::strict, strict},
+								{ sc::time_total, (time_end - time_begin).count() / 1'000'000.0 },
+								{ sc::unit, sc::milliseconds }
 							}
 						}
 					});
@@ -122,7 +161,7 @@ inline nlohmann::json cli(std::istream& commands, global& g) {
 			}
 
 			if (instruction == cli_commands::READ_GMC) {
-				if (items.size() != 3) throw failed_instruction("Wrong number of parameters.");
+				if (items.size() != 3 && items.size() != 4) throw failed_instruction("Wrong number of parameters.");
 				std::string& file_path = items[2];
 				std::size_t id{ 0 };
 				std::ifstream file{};
@@ -131,14 +170,23 @@ inline nlohmann::json cli(std::istream& commands, global& g) {
 					id = std::stoul(items[1]);
 				}
 				catch (...) { throw failed_instruction("Could not parse parameter"); }
+				const bool strict{ items.size() == 4 };
+				if (strict && items[3] != sc::strict) throw failed_instruction("Could not parse parameter.");
 				if (!file.good()) throw failed_instruction("Could not open file.");
+				file.close();
 				if (g.markov_chains[id] == nullptr) throw failed_instruction("No mc with given ID");
-				g.markov_chains[id]->read_from_gmc_file(file);
+				g.invalidate_solvers_of_mc(id);
+				const auto time_begin{ std::chrono::steady_clock::now() };
+				g.markov_chains[id]->read_from_gmc_file(file_path, strict);
+				const auto time_end{ std::chrono::steady_clock::now() };
 				performance_log.push_back({
 						{instruction,
 							{
 								{ sc::markov_chain_id, id},
-								{ sc::file_path, file_path}
+								{ sc::file_path, file_path},
+								{ sc::strict, strict},
+								{ sc::time_total, (time_end - time_begin).count() / 1'000'000.0 },
+								{ sc::unit, sc::milliseconds }
 							}
 						}
 					});
@@ -146,7 +194,7 @@ inline nlohmann::json cli(std::istream& commands, global& g) {
 			}
 
 			if (instruction == cli_commands::ADD_REW) {
-				if (items.size() != 4) throw failed_instruction("Wrong number of parameters.");
+				if (items.size() != 4 && items.size() != 5) throw failed_instruction("Wrong number of parameters.");
 				std::string& file_path = items[2];
 				std::size_t rew_index{ 0 };
 				global::id id{ 0 };
@@ -157,15 +205,173 @@ inline nlohmann::json cli(std::istream& commands, global& g) {
 					rew_index = std::stoull(items[3]);
 				}
 				catch (...) { throw failed_instruction("Could not parse parameter."); }
+				const bool strict{ items.size() == 5 };
+				if (strict && items[4] != sc::strict) throw failed_instruction("Could not parse parameter.");
 				if (!file.good()) throw failed_instruction("Could not open file.");
+				file.close();
 				if (g.markov_chains[id] == nullptr) throw failed_instruction("No mc with given ID");
-				g.markov_chains[id]->read_rewards_from_prism_file(file, rew_index);
+				const auto time_begin{ std::chrono::steady_clock::now() };
+				g.markov_chains[id]->read_rewards_from_prism_file(file_path, rew_index, strict);
+				const auto time_end{ std::chrono::steady_clock::now() };
 				performance_log.push_back({
 						{instruction,
 							{
 								{ sc::markov_chain_id, id},
 								{ sc::decoration_index, rew_index },
-								{ sc::file_path, file_path}
+								{ sc::file_path, file_path},
+								{ sc::strict, strict},
+								{ sc::time_total, (time_end - time_begin).count() / 1'000'000.0 },
+								{ sc::unit, sc::milliseconds }
+							}
+						}
+					});
+				continue;
+			}
+
+			if (instruction == cli_commands::ADD_EDGE_DECO || instruction == cli_commands::ADD_NODE_DECO) {
+				if (items.size() != 2 && items.size() != 3) throw failed_instruction("Wrong number of parameters.");
+				global::id id{ 0 };
+				std::size_t count{ 1 };
+				try {
+					id = std::stoull(items[1]);
+					if (items.size() == 3) count = std::stoull(items[2]);
+				}
+				catch (...) { throw failed_instruction("Could not parse parameter."); }
+				if (g.markov_chains[id] == nullptr) throw failed_instruction("No markov chain present with given ID.");
+				const auto time_begin{ std::chrono::steady_clock::now() };
+				if (instruction == cli_commands::ADD_EDGE_DECO)
+					g.markov_chains[id]->add_edge_decorations(count);
+				else
+					g.markov_chains[id]->add_node_decorations(count);
+				const auto time_end{ std::chrono::steady_clock::now() };
+				performance_log.push_back({
+						{instruction,
+							{
+								{ sc::markov_chain_id, id },
+								{ sc::number_edge_decorations, g.markov_chains[id]->size_edge_decorations() },
+								{ sc::number_node_decorations, g.markov_chains[id]->size_node_decorations() },
+								{ sc::time_total, (time_end - time_begin).count() / 1'000'000.0 },
+								{ sc::unit, sc::milliseconds }
+							}
+						}
+					});
+				continue;
+			}
+
+			if (instruction == cli_commands::DROP_EDGE_DECO || instruction == cli_commands::DROP_NODE_DECO) {
+				if (items.size() != 3) throw failed_instruction("Wrong number of parameters.");
+				global::id id{ 0 };
+				std::size_t deco_index{ 0 };
+				try {
+					id = std::stoull(items[1]);
+					deco_index = std::stoull(items[2]);
+				}
+				catch (...) { throw failed_instruction("Could not parse parameter."); }
+				if (g.markov_chains[id] == nullptr) throw failed_instruction("No markov chain present with given ID.");
+				const auto time_begin{ std::chrono::steady_clock::now() };
+				if (instruction == cli_commands::DROP_EDGE_DECO) {
+					if (!(deco_index < g.markov_chains[id]->size_edge_decorations())) throw failed_instruction("No edge decoration with given index.");
+					g.markov_chains[id]->drop_edge_decoration(deco_index);
+				}
+				else {
+					if (!(deco_index < g.markov_chains[id]->size_node_decorations())) throw failed_instruction("No node decoration with given index.");
+					g.markov_chains[id]->drop_node_decoration(deco_index);
+				}
+				const auto time_end{ std::chrono::steady_clock::now() };
+				performance_log.push_back({
+						{instruction,
+							{
+								{ sc::markov_chain_id, id },
+								{ sc::decoration_index, deco_index },
+								{ sc::number_edge_decorations, g.markov_chains[id]->size_edge_decorations() },
+								{ sc::number_node_decorations, g.markov_chains[id]->size_node_decorations() },
+								{ sc::time_total, (time_end - time_begin).count() / 1'000'000.0 },
+								{ sc::unit, sc::milliseconds }
+							}
+						}
+					});
+				continue;
+			}
+
+			if (instruction == cli_commands::FREEZE_MC) {
+				if (items.size() != 2) throw failed_instruction("Wrong number of parameters.");
+				global::id id{ 0 };
+				try {
+					id = std::stoull(items[1]);
+				}
+				catch (...) { throw failed_instruction("Could not parse parameter."); }
+				if (g.markov_chains[id] == nullptr) throw failed_instruction("No markov chain present with given ID.");
+				const auto time_begin{ std::chrono::steady_clock::now() };
+				g.markov_chains[id]->freeze();
+				const auto time_end{ std::chrono::steady_clock::now() };
+				performance_log.push_back({
+						{instruction,
+							{
+								{ sc::markov_chain_id, id },
+								{ sc::time_freeze, (time_end - time_begin).count() / 1'000'000.0 },
+								{ sc::unit, sc::milliseconds }
+							}
+						}
+					});
+				continue;
+			}
+
+			if (instruction == cli_commands::SAVE_BIN) {
+				if (items.size() != 3) throw failed_instruction("Wrong number of parameters.");
+				std::string& file_path = items[2];
+				global::id id{ 0 };
+				try {
+					id = std::stoull(items[1]);
+				}
+				catch (...) { throw failed_instruction("Could not parse parameter."); }
+				if (g.markov_chains[id] == nullptr) throw failed_instruction("No markov chain present with given ID.");
+				std::ofstream file{ file_path, std::ios_base::binary };
+				if (!file.good()) throw failed_instruction("Bad file.");
+				const auto time_begin{ std::chrono::steady_clock::now() };
+				g.markov_chains[id]->write_binary(file);
+				file.close();
+				const auto time_end{ std::chrono::steady_clock::now() };
+				performance_log.push_back({
+						{instruction,
+							{
+								{ sc::markov_chain_id, id },
+								{ sc::file_path, file_path },
+								{ sc::size_nodes, g.markov_chains[id]->size_states() },
+								{ sc::size_edges, g.markov_chains[id]->size_edges() },
+								{ sc::time_total, (time_end - time_begin).count() / 1'000'000.0 },
+								{ sc::unit, sc::milliseconds }
+							}
+						}
+					});
+				continue;
+			}
+
+			if (instruction == cli_commands::LOAD_BIN) {
+				if (items.size() != 3) throw failed_instruction("Wrong number of parameters.");
+				std::string& file_path = items[2];
+				global::id id{ 0 };
+				try {
+					id = std::stoull(items[1]);
+				}
+				catch (...) { throw failed_instruction("Could not parse parameter."); }
+				std::ifstream file{ file_path, std::ios_base::binary };
+				if (!file.good()) throw failed_instruction("Could not open file.");
+				file.close();
+				const auto time_begin{ std::chrono::steady_clock::now() };
+				auto loaded{ std::make_unique<mc_type>(0, 0) };
+				loaded->read_binary(file_path);
+				const auto time_end{ std::chrono::steady_clock::now() };
+				g.markov_chains[id] = std::move(loaded);
+				g.invalidate_solvers_of_mc(id);
+				performance_log.push_back({
+						{instruction,
+							{
+								{ sc::markov_chain_id, id },
+								{ sc::file_path, file_path },
+								{ sc::size_nodes, g.markov_chains[id]->size_states() },
+								{ sc::size_edges, g.markov_chains[id]->size_edges() },
+								{ sc::time_total, (time_end - time_begin).count() / 1'000'000.0 },
+								{ sc::unit, sc::milliseconds }
 							}
 						}
 					});
@@ -183,14 +389,16 @@ inline nlohmann::json cli(std::istream& commands, global& g) {
 				}
 				catch (...) { throw failed_instruction("Could not parse parameter."); }
 				if (!file.good()) throw failed_instruction("Could not open file.");
+				g.invalidate_solvers_of_ts(id);
 				g.target_sets[id] = std::make_unique<global::set_type>(
-					std::move(int_set<global::int_type>::stointset(file, [](auto s) { return std::stoull(s); }))
+					int_set<global::int_type>::stointset<global::set_type>(file, [](auto s) { return std::stoull(s); })
 					);
 				performance_log.push_back({
 						{instruction,
 							{
 								{ sc::target_set_id, id},
-								{ sc::file_path, file_path}
+								{ sc::file_path, file_path},
+								{ sc::size_target_set, g.target_sets[id]->size() }
 							}
 						}
 					});
@@ -210,15 +418,82 @@ inline nlohmann::json cli(std::istream& commands, global& g) {
 				}
 				catch (...) { throw failed_instruction("Could not parse parameter."); }
 				if (!file.good()) throw failed_instruction("Could not open file.");
+				g.invalidate_solvers_of_ts(id);
 				g.target_sets[id] = std::make_unique<global::set_type>(
-					std::move(int_set<global::int_type>::prismlabeltointset(file, [](auto s) { return std::stoull(s); }, label_id))
+					int_set<global::int_type>::prismlabeltointset<global::set_type>(file, [](auto s) { return std::stoull(s); }, label_id)
 					);
 				performance_log.push_back({
 						{instruction,
 							{
 								{ sc::target_set_id, id },
 								{ sc::file_path, file_path },
-								{ sc::prism_label_id, label_id }
+								{ sc::prism_label_id, label_id },
+								{ sc::size_target_set, g.target_sets[id]->size() }
+							}
+						}
+					});
+				continue;
+			}
+
+			if (instruction == cli_commands::UNION_TS || instruction == cli_commands::INTERSECT_TS) {
+				if (items.size() != 4) throw failed_instruction("Wrong number of parameters.");
+				global::id id{ 0 }, id_1{ 0 }, id_2{ 0 };
+				try {
+					id = std::stoull(items[1]);
+					id_1 = std::stoull(items[2]);
+					id_2 = std::stoull(items[3]);
+				}
+				catch (...) { throw failed_instruction("Could not parse parameter."); }
+				if (g.target_sets[id_1] == nullptr || g.target_sets[id_2] == nullptr) throw failed_instruction("No target set with given ID");
+				const auto time_begin{ std::chrono::steady_clock::now() };
+				auto result{ std::make_unique<global::set_type>(*g.target_sets[id_1]) };
+				if (instruction == cli_commands::UNION_TS)
+					*result |= *g.target_sets[id_2];
+				else
+					*result &= *g.target_sets[id_2];
+				const auto time_end{ std::chrono::steady_clock::now() };
+				g.invalidate_solvers_of_ts(id);
+				g.target_sets[id] = std::move(result);
+				performance_log.push_back({
+						{instruction,
+							{
+								{ sc::target_set_id, id },
+								{ sc::source_target_set_ids, std::vector<global::id>{ id_1, id_2 } },
+								{ sc::size_target_set, g.target_sets[id]->size() },
+								{ sc::time_total, (time_end - time_begin).count() / 1'000'000.0 },
+								{ sc::unit, sc::milliseconds }
+							}
+						}
+					});
+				continue;
+			}
+
+			if (instruction == cli_commands::COMPLEMENT_TS) {
+				if (items.size() != 4) throw failed_instruction("Wrong number of parameters.");
+				global::id id{ 0 }, source_id{ 0 }, mc_id{ 0 };
+				try {
+					id = std::stoull(items[1]);
+					source_id = std::stoull(items[2]);
+					mc_id = std::stoull(items[3]);
+				}
+				catch (...) { throw failed_instruction("Could not parse parameter."); }
+				if (g.target_sets[source_id] == nullptr) throw failed_instruction("No target set with given ID");
+				if (g.markov_chains[mc_id] == nullptr) throw failed_instruction("No markov chain present with given ID.");
+				const auto time_begin{ std::chrono::steady_clock::now() };
+				auto result{ std::make_unique<global::set_type>(g.markov_chains[mc_id]->state_id_set()) };
+				*result -= *g.target_sets[source_id];
+				const auto time_end{ std::chrono::steady_clock::now() };
+				g.invalidate_solvers_of_ts(id);
+				g.target_sets[id] = std::move(result);
+				performance_log.push_back({
+						{instruction,
+							{
+								{ sc::target_set_id, id },
+								{ sc::source_target_set_ids, std::vector<global::id>{ source_id } },
+								{ sc::markov_chain_id, mc_id },
+								{ sc::size_target_set, g.target_sets[id]->size() },
+								{ sc::time_total, (time_end - time_begin).count() / 1'000'000.0 },
+								{ sc::unit, sc::milliseconds }
 							}
 						}
 					});
@@ -226,7 +501,9 @@ inline nlohmann::json cli(std::istream& commands, global& g) {
 			}
 
 			if (instruction == cli_commands::CALC_EXPECT) {
-				if (items.size() != 5) throw failed_instruction("Wrong number of parameters.");
+				if (items.size() < 5) throw failed_instruction("Wrong number of parameters.");
+				solver_parameters prm{ g.solver_config };
+				parse_solver_parameters(items.cbegin() + 5, items.cend(), prm);
 				std::size_t reward_index{ 0 }, destination_decoration{ 0 };
 				global::id mc_id{ 0 }, target_id{ 0 };
 				try {
@@ -238,7 +515,34 @@ inline nlohmann::json cli(std::istream& commands, global& g) {
 				catch (...) { throw failed_instruction("Could not parse parameter"); }
 				if (g.markov_chains[mc_id] == nullptr) throw failed_instruction("No mc with given ID");
 
-				auto&& log = calc_expect(*(g.markov_chains[mc_id]), reward_index, *(g.target_sets[target_id]), destination_decoration);
+				if (g.target_sets[target_id] == nullptr) throw failed_instruction("No target set with given ID");
+
+				auto&& log = calc_expect(*(g.markov_chains[mc_id]), reward_index, *(g.target_sets[target_id]), destination_decoration, g.solvers[{ mc_id, target_id }], prm, g.initial_state_of(mc_id));
+				log[instruction].push_back({ sc::markov_chain_id, mc_id });
+				log[instruction].push_back({ sc::target_set_id, target_id });
+				performance_log.push_back(std::move(log));
+				continue;
+			}
+
+			if (instruction == cli_commands::CALC_EXPECT_MULTI) {
+				// mc_id, target_id, (reward_index, destination_decoration)+, solver parameters*
+				const auto end_of_indices{ std::find_if(items.cbegin() + std::min<std::size_t>(items.size(), 3), items.cend(), [](const std::string& item) { return item.find('=') != std::string::npos; }) };
+				const std::size_t count_indices = end_of_indices - (items.cbegin() + std::min<std::size_t>(items.size(), 3));
+				if (items.size() < 5 || count_indices % 2) throw failed_instruction("Wrong number of parameters.");
+				solver_parameters prm{ g.solver_config };
+				parse_solver_parameters(end_of_indices, items.cend(), prm);
+				std::vector<std::pair<std::size_t, std::size_t>> reward_and_destination_indices;
+				global::id mc_id{ 0 }, target_id{ 0 };
+				try {
+					mc_id = std::stoull(items[1]);
+					target_id = std::stoull(items[2]);
+					for (std::size_t i{ 3 }; i < 3 + count_indices; i += 2)
+						reward_and_destination_indices.emplace_back(std::stoull(items[i]), std::stoull(items[i + 1]));
+				}
+				catch (...) { throw failed_instruction("Could not parse parameter"); }
+				if (g.markov_chains[mc_id] == nullptr) throw failed_instruction("No mc with given ID");
+				if (g.target_sets[target_id] == nullptr) throw failed_instruction("No target set with given ID");
+				auto&& log = calc_expect_multi(*(g.markov_chains[mc_id]), reward_and_destination_indices, *(g.target_sets[target_id]), g.solvers[{ mc_id, target_id }], prm, g.initial_state_of(mc_id));
 				log[instruction].push_back({ sc::markov_chain_id, mc_id });
 				log[instruction].push_back({ sc::target_set_id, target_id });
 				performance_log.push_back(std::move(log));
@@ -246,9 +550,11 @@ inline nlohmann::json cli(std::istream& commands, global& g) {
 			}
 
 			if (instruction == cli_commands::CALC_VARIANCE) {
-				// mc_id, reward_index, target_id, destination_decoration, expect_decoration, free_reward
-				if (items.size() != 7) throw failed_instruction("Wrong number of parameters.");
-				std::size_t expect_decoration{ 0 }, destination_decoration{ 0 }, reward_index{ 0 }, free_reward{ 0 };
+				// mc_id, reward_index, target_id, destination_decoration, expect_decoration[, free_reward (ignored)]
+				if (items.size() < 6) throw failed_instruction("Wrong number of parameters.");
+				solver_parameters prm{ g.solver_config };
+				parse_solver_parameters(items.cbegin() + first_solver_parameter(items, 6), items.cend(), prm);
+				std::size_t expect_decoration{ 0 }, destination_decoration{ 0 }, reward_index{ 0 };
 				global::id target_id{ 0 }, mc_id{ 0 };
 				try {
 					mc_id = std::stoull(items[1]);
@@ -256,11 +562,11 @@ inline nlohmann::json cli(std::istream& commands, global& g) {
 					target_id = std::stoull(items[3]);
 					destination_decoration = std::stoull(items[4]);
 					expect_decoration = std::stoull(items[5]);
-					free_reward = std::stoull(items[6]);
 				}
 				catch (...) { throw failed_instruction("Could not parse parameter"); }
 				if (g.markov_chains[mc_id] == nullptr) throw failed_instruction("No mc with given ID");
-				auto&& log = calc_variance(*(g.markov_chains[mc_id]), reward_index, *(g.target_sets[target_id]), destination_decoration, expect_decoration, free_reward);
+				if (g.target_sets[target_id] == nullptr) throw failed_instruction("No target set with given ID");
+				auto&& log = calc_variance(*(g.markov_chains[mc_id]), reward_index, *(g.target_sets[target_id]), destination_decoration, expect_decoration, g.solvers[{ mc_id, target_id }], prm, g.initial_state_of(mc_id));
 				log[instruction].push_back({ sc::markov_chain_id, mc_id });
 				log[instruction].push_back({ sc::target_set_id, target_id });
 				performance_log.push_back(std::move(log));
@@ -276,15 +582,17 @@ inline nlohmann::json cli(std::istream& commands, global& g) {
 					>{state_decoration_index}
 					>{state_decoration_expects_index1}
 					>{state_decoration_expects_index2}
-					>{free_transition_decoration}
+					[>{free_transition_decoration}] (ignored)
+					[>{key}={value}]...
 				*/
-				if (items.size() != 9) throw failed_instruction("Wrong number of parameters.");
+				if (items.size() < 8) throw failed_instruction("Wrong number of parameters.");
+				solver_parameters prm{ g.solver_config };
+				parse_solver_parameters(items.cbegin() + first_solver_parameter(items, 8), items.cend(), prm);
 				std::size_t state_decoration_expects_index1{ 0 },
 					state_decoration_expects_index2{ 0 },
 					destination_decoration{ 0 },
 					edge_decoration_1{ 0 },
-					edge_decoration_2{ 0 },
-					free_reward{ 0 };
+					edge_decoration_2{ 0 };
 				global::id target_set_id{ 0 },
 					mc_id{ 0 };
 				try {
@@ -295,10 +603,10 @@ inline nlohmann::json cli(std::istream& commands, global& g) {
 					destination_decoration = std::stoull(items[5]);
 					state_decoration_expects_index1 = std::stoull(items[6]);
 					state_decoration_expects_index2 = std::stoull(items[7]);
-					free_reward = std::stoull(items[8]);
 				}
 				catch (...) { throw failed_instruction("Could not parse parameter"); }
 				if (g.markov_chains[mc_id] == nullptr) throw failed_instruction("No mc with given ID");
+				if (g.target_sets[target_set_id] == nullptr) throw failed_instruction("No target set with given ID");
 				auto&& log = calc_covariance(
 					*(g.markov_chains[mc_id]),
 					edge_decoration_1,
@@ -307,13 +615,53 @@ inline nlohmann::json cli(std::istream& commands, global& g) {
 					destination_decoration,
 					state_decoration_expects_index1,
 					state_decoration_expects_index2,
-					free_reward);
+					g.solvers[{ mc_id, target_set_id }],
+					prm,
+					g.initial_state_of(mc_id));
 				log[instruction].push_back({ sc::markov_chain_id, mc_id });
 				log[instruction].push_back({ sc::target_set_id, target_set_id });
 				performance_log.push_back(std::move(log));
 				continue;
 			}
 
+			if (instruction == cli_commands::SET_SOLVER) {
+				solver_parameters prm{ items.size() == 1 ? default_solver_parameters() : g.solver_config };
+				parse_solver_parameters(items.cbegin() + 1, items.cend(), prm);
+				g.solver_config = std::move(prm);
+				performance_log.push_back({
+						{instruction,
+							{
+								{ sc::solver_parameters, solver_parameters_to_json(g.solver_config) }
+							}
+						}
+					});
+				continue;
+			}
+
+			if (instruction == cli_commands::SET_INITIAL) {
+				if (items.size() != 2 && items.size() != 3) throw failed_instruction("Wrong number of parameters.");
+				global::id mc_id{ 0 };
+				global::int_type state_id{ 0 };
+				try {
+					mc_id = std::stoull(items[1]);
+					if (items.size() == 3) state_id = std::stoull(items[2]);
+				}
+				catch (...) { throw failed_instruction("Could not parse parameter."); }
+				if (items.size() == 3)
+					g.initial_states[mc_id] = state_id;
+				else
+					g.initial_states.erase(mc_id);
+				performance_log.push_back({
+						{instruction,
+							{
+								{ sc::markov_chain_id, mc_id },
+								{ sc::initial_state, items.size() == 3 ? nlohmann::json(state_id) : nlohmann::json() }
+							}
+						}
+					});
+				continue;
+			}
+
 			if (instruction == cli_commands::WRITE_DECO) {
 				if (items.size() != 3) throw failed_instruction("Wrong number of parameters.");
 				std::string& file_path = items[2];
@@ -350,6 +698,8 @@ inline nlohmann::json cli(std::istream& commands, global& g) {
 				catch (...) { throw failed_instruction("Could not parse parameter"); }
 				if (g.markov_chains[mc_id] == nullptr) throw failed_instruction("No mc with given ID");
 
+				g.invalidate_solvers_of_mc(mc_id);
+				g.invalidate_solvers_of_ts(target_set_id);
 				auto&& log = generate_herman(*g.markov_chains[mc_id], size, g.target_sets[target_set_id]);
 				log[instruction].push_back({ sc::markov_chain_id, mc_id });
 				log[instruction].push_back({ sc::target_set_id, target_set_id });
@@ -366,14 +716,22 @@ inline nlohmann::json cli(std::istream& commands, global& g) {
 				}
 				catch (...) { throw failed_instruction("Could not parse parameter"); }
 				if (g.markov_chains[id] == nullptr) throw failed_instruction("No mc with given ID");
+				const bool frozen{ g.markov_chains[id]->frozen() };
+				const auto allocations{ g.markov_chains[id]->edge_allocation_statistics() };
+				const auto time_begin{ std::chrono::steady_clock::now() };
 				g.markov_chains.erase(id);
-				performance_log.push_back({
-						{instruction,
-							{
-								{ sc::markov_chain_id, id }
-							}
-						}
-					});
+				const auto time_end{ std::chrono::steady_clock::now() };
+				g.invalidate_solvers_of_mc(id);
+				nlohmann::json log = {
+					{ sc::markov_chain_id, id },
+					{ sc::time_total, (time_end - time_begin).count() / 1'000'000.0 },
+					{ sc::unit, sc::milliseconds }
+				};
+				if (!frozen) { // a frozen markov chain does not use the edge arena any more
+					log[sc::edge_allocations] = allocations.allocations;
+					log[sc::arena_blocks] = allocations.blocks;
+				}
+				performance_log.push_back({ { instruction, log } });
 				continue;
 			}
 
@@ -386,6 +744,7 @@ inline nlohmann::json cli(std::istream& commands, global& g) {
 				catch (...) { throw failed_instruction("Could not parse parameter"); }
 				if (g.target_sets[id] == nullptr) throw failed_instruction("No mc with given ID");
 				g.target_sets.erase(id);
+				g.invalidate_solvers_of_ts(id);
 				performance_log.push_back({
 						{instruction,
 							{
@@ -404,15 +763,19 @@ inline nlohmann::json cli(std::istream& commands, global& g) {
 				}
 				catch (...) { throw failed_instruction("Could not parse parameter"); }
 				if (g.markov_chains[id] == nullptr) throw std::logic_error("No mc with given ID");
-				performance_log.push_back({
-						{instruction,
-							{
-								{ sc::markov_chain_id, id },
-								{ sc::size_nodes, g.markov_chains[id]->size_states() },
-								{ sc::size_edges, g.markov_chains[id]->size_edges() }
-							}
-						}
-					});
+				const auto& mc{ *g.markov_chains[id] };
+				nlohmann::json log = {
+					{ sc::markov_chain_id, id },
+					{ sc::size_nodes, mc.size_states() },
+					{ sc::size_edges, mc.size_edges() },
+					{ sc::frozen, mc.frozen() }
+				};
+				if (!mc.frozen()) { // a frozen markov chain does not use the edge arena any more
+					log[sc::edge_allocations] = mc.edge_allocation_statistics().allocations;
+					log[sc::arena_blocks] = mc.edge_allocation_statistics().blocks;
+					log[sc::arena_bytes] = mc.edge_allocation_statistics().bytes;
+				}
+				performance_log.push_back({ { instruction, log } });
 				continue;
 			}
 
@@ -26,29 +26,97 @@ struct cli_commands {
 
 	/**
 		@brief Reads transitions from prism's file format to build up a markov chain.
-		@details Syntax: read_tra>{id}>{file}
+		@details Syntax: read_tra>{id}>{file}[>strict]
+		@details The file is memory-mapped and parsed line by line. The created markov chain is already frozen (see freeze_mc).
 		@param id id where the markov chain is stored. It must have been initialized before (with reset_mc) and be empty.
 		@param file file path of the *.tra file to read
+		@param strict if given, the whole file is additionally validated by a regex before parsing. This is slow for big files.
 	*/
 	inline static const auto READ_TRA{ "read_tra" }; // id, file
 
 	/**
 		@brief Reads a markov chain from general markov chain (gmc) format, a file format introduced with this tool.
-		@details Syntax: read_gmc>{id}>{file}
+		@details Syntax: read_gmc>{id}>{file}[>strict]
+		@details The file is memory-mapped and parsed line by line. The created markov chain is already frozen (see freeze_mc).
 		@param id id where the markov chain is stored. It must have been initialized before (with reset_mc) and be empty.
 		@param file file path of the *.gmc file to read
+		@param strict if given, the whole file is additionally validated by regexes before parsing. This is slow for big files.
 	*/
 	inline static const auto READ_GMC{ "read_gmc" };
 
 	/**
 		@brief Reads edge decorations (rewards) from prism's trew file format. Needs an initialized non-empty markov chain thatt already has a transition for each reward defined in file.
-		@details Syntax: add_rew>{id}>{file}>{decoration_index}
+		@details Syntax: add_rew>{id}>{file}>{decoration_index}[>strict]
 		@param id id where the markov chain is stored. It must have been initialized before (with reset_mc) and be empty.
 		@param file file path of the *.trew file to read
 		@param decoration_index index where to store the reward values into each edge.
+		@param strict if given, the whole file is additionally validated by a regex before parsing. This is slow for big files.
 	*/
 	inline static const auto ADD_REW{ "add_rew" };
 
+	/**
+		@brief Appends edge decorations initialized with 0 to each edge of a markov chain, e.g. to make room for another reward (add_rew).
+		@details Syntax: add_edge_deco>{id}[>{count}]
+		@details The markov chain is frozen before (see freeze_mc). Only the decoration columns are touched, transitions and existing decorations stay as they are.
+		@param id id where the markov chain is stored.
+		@param count number of decorations to append, 1 if omitted.
+	*/
+	inline static const auto ADD_EDGE_DECO{ "add_edge_deco" };
+
+	/**
+		@brief Removes one edge decoration from each edge of a markov chain.
+		@details Syntax: drop_edge_deco>{id}>{decoration_index}
+		@details The markov chain is frozen before (see freeze_mc). Edge decorations at greater indices move down by one.
+		@param id id where the markov chain is stored.
+		@param decoration_index index of the edge decoration to remove.
+	*/
+	inline static const auto DROP_EDGE_DECO{ "drop_edge_deco" };
+
+	/**
+		@brief Appends node decorations initialized with 0 to each state of a markov chain, e.g. to store further results of calc_expect.
+		@details Syntax: add_node_deco>{id}[>{count}]
+		@details The markov chain is frozen before (see freeze_mc). Only the decoration columns are touched, transitions and existing decorations stay as they are.
+		@param id id where the markov chain is stored.
+		@param count number of decorations to append, 1 if omitted.
+	*/
+	inline static const auto ADD_NODE_DECO{ "add_node_deco" };
+
+	/**
+		@brief Removes one node decoration from each state of a markov chain.
+		@details Syntax: drop_node_deco>{id}>{decoration_index}
+		@details The markov chain is frozen before (see freeze_mc). Node decorations at greater indices move down by one.
+		@param id id where the markov chain is stored.
+		@param decoration_index index of the node decoration to remove.
+	*/
+	inline static const auto DROP_NODE_DECO{ "drop_node_deco" };
+
+	/**
+		@brief Turns a markov chain into its compact representation (contiguous CSR arrays). No more transitions can be added afterwards.
+		@details Syntax: freeze_mc>{id}
+		@details All calculations (calc_expect, calc_variance, calc_covariance) freeze the markov chain automatically if it is not yet frozen.
+		State ids need not be contiguous, the states are enumerated densely in ascending order of their ids.
+		@param id id where the markov chain is stored.
+	*/
+	inline static const auto FREEZE_MC{ "freeze_mc" };
+
+	/**
+		@brief Writes a markov chain into a binary snapshot file, containing its compact representation, all decorations and a checksum. The markov chain is frozen before.
+		@details Syntax: save_bin>{id}>{file}
+		@details Loading a snapshot with load_bin is much faster than parsing text files again, use it for repeated analyses of the same model.
+		@param id id where the markov chain is stored.
+		@param file file path of the snapshot to write
+	*/
+	inline static const auto SAVE_BIN{ "save_bin" };
+
+	/**
+		@brief Loads a markov chain from a binary snapshot file written by save_bin. The loaded markov chain is frozen.
+		@details Syntax: load_bin>{id}>{file}
+		@details Any markov chain stored at {id} is replaced. Numbers of edge and node decorations are taken from the snapshot.
+		@param id id where the markov chain is stored.
+		@param file file path of the snapshot to read
+	*/
+	inline static const auto LOAD_BIN{ "load_bin" };
+
 	/**
 		@brief Reads a set of integers from a file to store it as target set for expect / variance / cobvaraiance calculation
 		@details Syntax: read_target>{id}>{file}
@@ -65,9 +133,37 @@ struct cli_commands {
 	*/
 	inline static const auto READ_LABEL{ "read_label" };
 
+	/**
+		@brief Stores the union of two target sets as target set. Works on 64 states at once.
+		@details Syntax: union_ts>{id}>{id_1}>{id_2}
+		@param id id where the result is stored. Previous target set located at given id will be overwritten. May equal {id_1} or {id_2}.
+		@param id_1 id of the first target set
+		@param id_2 id of the second target set
+	*/
+	inline static const auto UNION_TS{ "union_ts" };
+
+	/**
+		@brief Stores the intersection of two target sets as target set. Works on 64 states at once.
+		@details Syntax: intersect_ts>{id}>{id_1}>{id_2}
+		@param id id where the result is stored. Previous target set located at given id will be overwritten. May equal {id_1} or {id_2}.
+		@param id_1 id of the first target set
+		@param id_2 id of the second target set
+	*/
+	inline static const auto INTERSECT_TS{ "intersect_ts" };
+
+	/**
+		@brief Stores the complement of a target set with respect to all states of a markov chain as target set. Works on 64 states at once.
+		@details Syntax: complement_ts>{id}>{source_id}>{mc_id}
+		@param id id where the result is stored. Previous target set located at given id will be overwritten. May equal {source_id}.
+		@param source_id id of the target set to complement
+		@param mc_id id of the markov chain whose states are complemented against
+	*/
+	inline static const auto COMPLEMENT_TS{ "complement_ts" };
+
 	/**
 		@brief Calculates for each state of the markov chain the expect of accumulated transition decoration (rewards) until reaching the first state in target set.
-		@details Syntax: calc_expect>{mc_id}>{transition_decoration_index}>{target_set_id}>{state_decoration_index}
+		@details Syntax: calc_expect>{mc_id}>{transition_decoration_index}>{target_set_id}>{state_decoration_index}[>{key}={value}]...
+		@details Optional trailing parameters {key}={value} override the solver configuration (see set_solver) for this instruction only.
 		@param mc_id id where the markov chain is stored.
 		@param transition_decoration_index Index of transition decorations (rewards) for that the expect should be calculated
 		@param target_set_id Id to find the set of goal states.
@@ -75,21 +171,37 @@ struct cli_commands {
 	*/
 	inline static const auto CALC_EXPECT{ "calc_expect" };
 
+	/**
+		@brief Calculates for each state of the markov chain the expects of several transition decorations (rewards) until reaching the first state in target set.
+		@details Syntax: calc_expect_multi>{mc_id}>{target_set_id}>{transition_decoration_index_1}>{state_decoration_index_1}[>{transition_decoration_index_2}>{state_decoration_index_2}]...[>{key}={value}]...
+		@details All rewards share one system matrix and one solver set-up, which is faster than calling calc_expect once per reward.
+		Optional trailing parameters {key}={value} override the solver configuration (see set_solver) for this instruction only.
+		@param mc_id id where the markov chain is stored.
+		@param target_set_id Id to find the set of goal states.
+		@param transition_decoration_index_i Index of transition decorations (rewards) for that the expect should be calculated
+		@param state_decoration_index_i Index of state decorations where the expect for the i-th reward should be stored.
+	*/
+	inline static const auto CALC_EXPECT_MULTI{ "calc_expect_multi" };
+
 	/**
 		@brief Calculates for each state of the markov chain the variance of accumulated transition decoration (rewards) until reaching the first state in target set.
-		@details Syntax: calc_variance>{mc_id}>{transition_decoration_index}>{target_set_id}>{state_decoration_index}>{state_decoration_expects_index}>{free_transition_decoration}
+		@details Syntax: calc_variance>{mc_id}>{transition_decoration_index}>{target_set_id}>{state_decoration_index}>{state_decoration_expects_index}[>{free_transition_decoration}][>{key}={value}]...
+		@details The trailing free transition decoration that former versions required is accepted but ignored: no transition decoration is written, interim results are not stored per transition any more.
+		@details Optional trailing parameters {key}={value} override the solver configuration (see set_solver) for this instruction only.
 		@param mc_id id where the markov chain is stored.
 		@param transition_decoration_index Index of transition decorations (rewards) for that the variance should be calculated
 		@param target_set_id Id to find the set of goal states.
 		@param state_decoration_index Index of state decorations where the variances should be stored.
 		@param state_decoration_expects_index Index of state decorations where the expects should be stored. (Note: the algorithm needs to calculate also expects in order to be able to claculate variances.)
-		@param free_transition_decoration Index for storing interim results as transition decorations. Choose a free index that contains values which can be overwritten.
+		@param free_transition_decoration Ignored. Former versions stored interim results there, it is only accepted for compatibility.
 	*/
 	inline static const auto CALC_VARIANCE{ "calc_variance" };
 
 	/**
 		@brief Calculates for each state of the markov chain the covariance of accumulated transition decoration (rewards) until reaching the first state in target set.
-		@details Syntax: calc_covariance>{mc_id}>{edge_decoration_1}>{edge_decoration_2}>{target_set_id}>{state_decoration_index}>{state_decoration_expects_index1}>{state_decoration_expects_index2}>{free_transition_decoration}
+		@details Syntax: calc_covariance>{mc_id}>{edge_decoration_1}>{edge_decoration_2}>{target_set_id}>{state_decoration_index}>{state_decoration_expects_index1}>{state_decoration_expects_index2}[>{free_transition_decoration}][>{key}={value}]...
+		@details The trailing free transition decoration that former versions required is accepted but ignored: no transition decoration is written, interim results are not stored per transition any more.
+		@details Optional trailing parameters {key}={value} override the solver configuration (see set_solver) for this instruction only.
 		@param mc_id id where the markov chain is stored.
 		@param edge_decoration_1 Index of transition decorations (1. reward function) for that the variance should be calculated
 		@param edge_decoration_2 Index of transition decorations (2. reward function) for that the variance should be calculated
@@ -97,10 +209,46 @@ struct cli_commands {
 		@param state_decoration_index Index of state decorations where the variances should be stored.
 		@param state_decoration_expects_index1 Index of state decorations where the expects for the 1. reward function should be stored. (Note: the algorithm needs to calculate also expects in order to be able to claculate variances.)
 		@param state_decoration_expects_index2 Index of state decorations where the expects for the 2. reward function should be stored. (Note: the algorithm needs to calculate also expects in order to be able to claculate variances.)
-		@param free_transition_decoration Index for storing interim results as transition decorations. Choose a free index that contains values which can be overwritten.
+		@param free_transition_decoration Ignored. Former versions stored interim results there, it is only accepted for compatibility.
 	*/
 	inline static const auto CALC_COVARIANCE{ "calc_covariance" };
 
+	/**
+		@brief Sets the solver configuration used by all following calc instructions.
+		@details Syntax: set_solver[>{key}={value}]...
+		@details Keys are those of AMGCL's runtime interface, e.g. solver.type (cg, bicgstab, gmres, idrs, ...), solver.tol, solver.maxiter, solver.M, solver.s,
+		precond.coarsening.type (aggregation, smoothed_aggregation, ...), precond.relax.type (spai0, ilu0, gauss_seidel, ...).
+		Key engine selects how the system is solved: auto (default) uses direct for systems of up to direct.max_size states (default 10000) and amg for bigger ones.
+		direct factorizes the system once by LU decomposition (dense for up to direct.dense_max states (default 256), skyline with Cuthill-McKee ordering otherwise) and reuses it for all solves.
+		amg runs the AMG preconditioned solver on the whole system,
+		scc solves strongly connected components one after another, trivial ones by back-substitution, components of up to scc.dense_max states (default 256) by dense LU and bigger ones by AMG.
+		Key precision (double (default), single or mixed) selects the scalar type of the matrix, the AMG hierarchy and the Krylov iterations wherever AMG is used. single halves their memory,
+		but the residual cannot get much below 1e-6, so solver.tol must be raised accordingly. Results are always reported in double.
+		mixed runs AMG and Krylov iterations in single precision up to solver.tol (default 1e-4) and refines the solution in double until its relative residual meets refinement.tol (default 1e-8),
+		at the latest after refinement.maxiter steps (default 100).
+		jacobi, gauss_seidel and interval iterate on the system without setting up AMG, which only needs memory for a few vectors. They stop when iteration.tol (default 1e-8) is met
+		according to iteration.criterion (relative (default) or absolute), at the latest after iteration.maxiter sweeps. interval iteration encloses each value from below and above, so the result is guaranteed to meet the tolerance.
+		Given parameters are added to the current configuration. Without parameters, the configuration is reset to the default (auto, aggregation, spai0, cg).
+		Example: set_solver>solver.type=bicgstab>precond.relax.type=ilu0>solver.tol=1e-10
+		Example: set_solver>engine=scc>scc.dense_max=64
+		Example: set_solver>engine=amg>precision=single>solver.tol=1e-6
+		Example: set_solver>engine=amg>precision=mixed>refinement.tol=1e-10
+		Example: calc_expect>0>0>0>1>engine=gauss_seidel>iteration.tol=1e-10
+		@param key=value a solver parameter
+	*/
+	inline static const auto SET_SOLVER{ "set_solver" };
+
+	/**
+		@brief Sets the initial state of a markov chain. Following calc instructions on this markov chain only solve for states reachable from it.
+		@details Syntax: set_initial>{mc_id}[>{state_id}]
+		@details Independent of the initial state, target states get value 0 and states reaching the target with probability less than 1 get infinity without being solved for.
+		States unreachable from the initial state get NaN. Without {state_id}, the initial state is removed and all states are solved for.
+		The setting belongs to {mc_id} and is kept until changed by set_initial.
+		@param mc_id id of the markov chain
+		@param state_id id of the initial state
+	*/
+	inline static const auto SET_INITIAL{ "set_initial" };
+
 	//inline static const auto write_gmc{ "write_gmc" }; //##not implemented
 
 	/**
@@ -123,6 +271,7 @@ struct cli_commands {
 	/**
 		@brief Deletes a markov chain.
 		@details Syntax: del_mc>{id}
+		@details Allocation statistics of the edge arena are only logged if the markov chain is not frozen.
 		@param id Id of the markov chain to delete.
 	*/
 	inline static const auto DELETE_MC{ "del_mc" }; // id mc, n, targetset id
@@ -137,6 +286,7 @@ struct cli_commands {
 	/**
 		@brief Writes characteristic values about the markov chain into json log, e.g. number of states, number of transitions
 		@details Syntax: print_mc>{id}
+		@details Allocation statistics of the edge arena are only logged if the markov chain is not frozen, a frozen markov chain has released its arena.
 		@param id Id of the markov chain.
 	*/
 	inline static const auto PRINT_MC{ "print_mc" }; // id mc, n, targetset id
@@ -0,0 +1,69 @@
+/**
+ * @file dense_lu.h
+ *
+ * LU decomposition of small dense matrices.
+ *
+ */
+#pragma once
+
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+	@brief LU decomposition with partial pivoting of a dense n x n matrix, for solving many small linear systems exactly.
+	@details Factorizing costs O(n^3), solving O(n^2) per right-hand side. Meant for matrices of up to a few hundred rows.
+*/
+class dense_lu {
+	std::size_t n;
+	/// @brief L (below the diagonal, unit diagonal omitted) and U (on and above the diagonal), row-major.
+	std::vector<double> lu;
+	/// @brief Row \a i of the factorization is row \a pivots[i] of the original matrix.
+	std::vector<std::size_t> pivots;
+
+public:
+	/**
+		@brief Factorizes the n x n matrix given row-major by \a a.
+		@exception std::invalid_argument Matrix is singular.
+	*/
+	dense_lu(const std::size_t& n, std::vector<double> a) : n(n), lu(std::move(a)), pivots(n) {
+		if (lu.size() != n * n) throw std::invalid_argument("Matrix has wrong size.");
+		for (std::size_t i{ 0 }; i < n; ++i) pivots[i] = i;
+		for (std::size_t k{ 0 }; k < n; ++k) {
+			std::size_t pivot{ k };
+			for (std::size_t i{ k + 1 }; i < n; ++i)
+				if (std::abs(lu[i * n + k]) > std::abs(lu[pivot * n + k])) pivot = i;
+			if (lu[pivot * n + k] == 0) throw std::invalid_argument("Matrix is singular.");
+			if (pivot != k) {
+				for (std::size_t j{ 0 }; j < n; ++j) std::swap(lu[k * n + j], lu[pivot * n + j]);
+				std::swap(pivots[k], pivots[pivot]);
+			}
+			const double diagonal{ lu[k * n + k] };
+			for (std::size_t i{ k + 1 }; i < n; ++i) {
+				const double factor{ lu[i * n + k] /= diagonal };
+				if (factor == 0) continue;
+				for (std::size_t j{ k + 1 }; j < n; ++j) lu[i * n + j] -= factor * lu[k * n + j];
+			}
+		}
+	}
+
+	/// @brief Returns the number of rows.
+	std::size_t size() const noexcept { return n; }
+
+	/// @brief Returns x with A * x = \a b.
+	std::vector<double> operator()(const std::vector<double>& b) const {
+		std::vector<double> x(n);
+		for (std::size_t i{ 0 }; i < n; ++i) {
+			double sum{ b[pivots[i]] };
+			for (std::size_t j{ 0 }; j < i; ++j) sum -= lu[i * n + j] * x[j];
+			x[i] = sum;
+		}
+		for (std::size_t i{ n }; i-- > 0;) {
+			double sum{ x[i] };
+			for (std::size_t j{ i + 1 }; j < n; ++j) sum -= lu[i * n + j] * x[j];
+			x[i] = sum / lu[i * n + i];
+		}
+		return x;
+	}
+};
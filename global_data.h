@@ -1,6 +1,7 @@
 #pragma once
 
 #include "markov_chain.h"
+#include "mc_analyzer.h"
 
 
 struct global {
@@ -9,9 +10,37 @@ struct global {
 	using int_type = unsigned long; //###??  // ### what bit width is appropriate for measure purpose???, what for release
 	using rational_type = double;
 	using mc_type = markov_chain<rational_type, int_type>;
-	using set_type = std::unordered_set<int_type>;
+	using set_type = bit_set<int_type>;
 
 	std::map<id, std::unique_ptr<mc_type>> markov_chains;
 	std::map<id, std::unique_ptr<set_type>> target_sets;
 
-};
\ No newline at end of file
+	/// @brief Solver parameters used by all calc instructions unless overridden per instruction.
+	solver_parameters solver_config = default_solver_parameters();
+
+	/// @brief Initial states of markov chains, keyed by markov chain id. Calculations exclude states unreachable from the initial state.
+	std::map<id, int_type> initial_states;
+
+	/// @brief Solvers that have already been set up, keyed by (markov chain id, target set id).
+	std::map<std::pair<id, id>, std::shared_ptr<prepared_linear_system>> solvers;
+
+	/// @brief Returns the initial state set for the markov chain with given id, if any.
+	std::optional<int_type> initial_state_of(const id& mc_id) const {
+		const auto it{ initial_states.find(mc_id) };
+		if (it == initial_states.cend()) return std::nullopt;
+		return it->second;
+	}
+
+	/// @brief Drops all cached solvers that were set up for the markov chain with given id. Call whenever this markov chain changes.
+	void invalidate_solvers_of_mc(const id& mc_id) {
+		for (auto it = solvers.begin(); it != solvers.end();)
+			it = it->first.first == mc_id ? solvers.erase(it) : std::next(it);
+	}
+
+	/// @brief Drops all cached solvers that were set up for the target set with given id. Call whenever this target set changes.
+	void invalidate_solvers_of_ts(const id& ts_id) {
+		for (auto it = solvers.begin(); it != solvers.end();)
+			it = it->first.second == ts_id ? solvers.erase(it) : std::next(it);
+	}
+
+};
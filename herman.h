@@ -29,10 +29,9 @@
 template<class _Rationals, class _Integers, class _Set, bool disable_checks = false>
 nlohmann::json generate_herman(markov_chain<_Rationals, _Integers>& mc, const _Integers& size, std::unique_ptr<_Set>& target_set) {
 	//### get rid of unique ptr ? // -> then make unique must be replace set must be cleared. (just drop it or use inserter iterator???)
-	auto  performance_log{ nlohmann::json() };
+	nlohmann::json performance_log;
 	std::array<std::chrono::steady_clock::time_point, 3> timestamps;
 
-	using mc_type = markov_chain<_Rationals, _Integers>;
 	const _Integers INT1{ 1 };
 
 	// Compile-time checks:
@@ -143,9 +142,8 @@ nlohmann::json generate_herman(markov_chain<_Rationals, _Integers>& mc, const _I
 				next_state_copy |= _Integers(bit_to_map) << non_deterministic_positions[pos_it];
 			}
 			// Create edge:
-			const auto pEdge{ new typename mc_type::edge(unique_outgoing_edge_probability, mc.n_edge_decorations) };
+			const auto pEdge{ mc.create_edge(unique_outgoing_edge_probability) };
 			mc.forward_transitions[state][next_state_copy] = pEdge;
-			mc.inverse_transitions[next_state_copy][state] = pEdge;
 			pEdge->decorations[0] = _Rationals(1);
 		}
 	}
@@ -157,6 +155,9 @@ nlohmann::json generate_herman(markov_chain<_Rationals, _Integers>& mc, const _I
 		{sc::size, size },
 		{sc::size_nodes, mc.size_states() },
 		{sc::size_edges, mc.size_edges()},
+		{sc::edge_allocations, mc.edge_allocation_statistics().allocations },
+		{sc::arena_blocks, mc.edge_allocation_statistics().blocks },
+		{sc::arena_bytes, mc.edge_allocation_statistics().bytes },
 		{sc::time_run_checks, 1.0 * (timestamps[1] - timestamps[0]).count()/1'000'000.0 },
 		{sc::time_run_generator, 1.0 * (timestamps[2] - timestamps[1]).count()/1'000'000.0 },
 		{sc::time_total,  1.0 * (timestamps[2] - timestamps[0]).count() / 1'000'000.0},
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "regxc.h"
+#include "bit_set.h"
 
 #include <unordered_set>
 #include <istream>
@@ -20,14 +21,14 @@ template<class _IntegerT>
 struct int_set {
 
 	/**
-		@brief Reads a stream, extracts the integers and stores them into an \a std::unordered_set<_IntegerT>
+		@brief Reads a stream, extracts the integers and stores them into a set of type \a _Set, e.g. \a std::unordered_set<_IntegerT> or \a bit_set<_IntegerT>
 		@param input the stream to read from
 		@param string_to_int_conversion function to convert each single integer from string representation (\a std::string) to integer (\a _IntegerT)
 	*/
-	template<class T>
-	inline static std::unordered_set<_IntegerT> stointset(std::istream& input, T&& string_to_int_conversion) {
+	template<class _Set = std::unordered_set<_IntegerT>, class T>
+	inline static _Set stointset(std::istream& input, T&& string_to_int_conversion) {
 		using regex_iterator = boost::regex_iterator<std::string::const_iterator>;
-		auto result{ std::unordered_set<_IntegerT>() };
+		auto result{ _Set() };
 		input.unsetf(std::ios_base::skipws); // also read whitespaces
 		const auto input_string{ std::string(std::istream_iterator<char>(input),std::istream_iterator<char>()) };
 
@@ -42,16 +43,16 @@ struct int_set {
 	}
 
 	/**
-		@brief Reads labels from prism's file format and stores them into an \a std::unordered_set<_IntegerT>
+		@brief Reads labels from prism's file format and stores them into a set of type \a _Set, e.g. \a std::unordered_set<_IntegerT> or \a bit_set<_IntegerT>
 		@details Searches for all states that are labeled with \a label_id and put them into the returned set.
 		@param input the stream to read from
 		@param string_to_int_conversion function to convert each single state id from string representation (\a std::string) to integer (\a _IntegerT)
 		@param label_id label to consider
 	*/
-	template<class T>
-	inline static std::unordered_set<_IntegerT> prismlabeltointset(std::istream& input, T&& string_to_int_conversion, const std::size_t& label_id) {
+	template<class _Set = std::unordered_set<_IntegerT>, class T>
+	inline static _Set prismlabeltointset(std::istream& input, T&& string_to_int_conversion, const std::size_t& label_id) {
 		using regex_iterator = boost::regex_iterator<std::string::const_iterator>;
-		auto result{ std::unordered_set<_IntegerT>() };
+		auto result{ _Set() };
 		input.unsetf(std::ios_base::skipws); // also read whitespaces
 		const auto input_string{ std::string(std::istream_iterator<char>(input),std::istream_iterator<char>()) };
 
@@ -13,11 +13,13 @@ struct cli_params {
 
 	inline static const auto __instructions{ std::string("--instructions") };
 	inline static const auto __json_log{ std::string("--json-log") };
+	inline static const auto __threads{ std::string("--threads") };
 
 	std::istream* instructions{ nullptr };
 	std::ostream* json_log{ nullptr };
 	char* instructions_param{ nullptr };
 	char* json_log_param{ nullptr };
+	char* threads_param{ nullptr };
 };
 
 int main(int argc, char** argv)
@@ -29,14 +31,15 @@ int main(int argc, char** argv)
 
 	nlohmann::json performance_log;
 
-	std::vector<bool> recognized_params(argc, false);
+	const std::size_t n_params{ static_cast<std::size_t>(argc) };
+	std::vector<bool> recognized_params(n_params, false);
 	recognized_params[0] = true;
 	auto get_param = [&](std::size_t i) { return std::string(argv[i]); };
 
 	// parse params: look for known tokens
-	for (std::size_t i{ 1 }; i < argc; ++i) {
+	for (std::size_t i{ 1 }; i < n_params; ++i) {
 		if (get_param(i) == cli_params::__instructions) {
-			if (recognized_params[i] || !(i + 1 < argc)) {
+			if (recognized_params[i] || !(i + 1 < n_params)) {
 				std::cerr << "PARAM ERROR: " << get_param(i);
 				exit(1);
 			}
@@ -45,7 +48,7 @@ int main(int argc, char** argv)
 			params.instructions_param = argv[i + 1];
 		}
 		if (get_param(i) == cli_params::__json_log) {
-			if (recognized_params[i] || !(i + 1 < argc)) {
+			if (recognized_params[i] || !(i + 1 < n_params)) {
 				std::cerr << "PARAM ERROR: " << get_param(i);
 				exit(1);
 			}
@@ -53,6 +56,15 @@ int main(int argc, char** argv)
 			recognized_params[i + 1] = true;
 			params.json_log_param = argv[i + 1];
 		}
+		if (get_param(i) == cli_params::__threads) {
+			if (recognized_params[i] || !(i + 1 < n_params)) {
+				std::cerr << "PARAM ERROR: " << get_param(i);
+				exit(1);
+			}
+			recognized_params[i] = true;
+			recognized_params[i + 1] = true;
+			params.threads_param = argv[i + 1];
+		}
 	}
 
 	// check for unrecognized tokens:
@@ -74,6 +86,14 @@ int main(int argc, char** argv)
 		_Json_log_file.open(params.json_log_param);
 		params.json_log = &_Json_log_file;
 	}
+	if (params.threads_param) {
+		const auto threads{ std::string(params.threads_param) };
+		if (threads.empty() || !std::all_of(threads.cbegin(), threads.cend(), [](unsigned char c) { return std::isdigit(c); })) {
+			std::cerr << "PARAM ERROR: " << cli_params::__threads << " " << threads;
+			exit(1);
+		}
+		set_thread_count(std::stoull(threads)); // 0 means one thread per core
+	}
 	if constexpr (DEBUG_MODE) {
 		const auto FILE_PATH{ "R:\\c.txt" };
 		_Commands_from_file.open(FILE_PATH);
@@ -0,0 +1,55 @@
+/**
+ * @file mapped_file.h
+ *
+ * Read-only memory mapping of input files.
+ *
+ */
+#pragma once
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <fstream>
+#include <string>
+#include <stdexcept>
+
+/**
+	@brief Maps a whole file read-only into memory, so that parsers can work on a contiguous character range without copying the file.
+	@details The mapping is released on destruction. Empty files are not mapped, they yield an empty range.
+*/
+class mapped_file {
+	boost::interprocess::file_mapping mapping;
+	boost::interprocess::mapped_region region;
+
+public:
+	/**
+		@brief Maps the file at \a file_path.
+		@exception std::invalid_argument Could not open file.
+	*/
+	explicit mapped_file(const std::string& file_path) : mapping(), region() {
+		std::ifstream probe(file_path, std::ios_base::binary | std::ios_base::ate);
+		if (!probe.good()) throw std::invalid_argument("Could not open file.");
+		if (probe.tellg() == std::streampos(0)) return; // empty files cannot be mapped
+		probe.close();
+		try {
+			mapping = boost::interprocess::file_mapping(file_path.c_str(), boost::interprocess::read_only);
+			region = boost::interprocess::mapped_region(mapping, boost::interprocess::read_only);
+		}
+		catch (const boost::interprocess::interprocess_exception& e) {
+			throw std::invalid_argument(std::string("Could not map file: ") + e.what());
+		}
+		region.advise(boost::interprocess::mapped_region::advice_sequential);
+	}
+
+	mapped_file(const mapped_file&) = delete;
+	mapped_file& operator=(const mapped_file&) = delete;
+
+	/// @brief Returns a pointer to the first character of the file.
+	const char* begin() const noexcept { return static_cast<const char*>(region.get_address()); }
+
+	/// @brief Returns a pointer behind the last character of the file.
+	const char* end() const noexcept { return begin() + region.get_size(); }
+
+	/// @brief Returns the size of the file in bytes.
+	std::size_t size() const noexcept { return region.get_size(); }
+};
@@ -9,6 +9,12 @@
 #include "regxc.h"
 #include "loghelper.h"
 #include "sparse_matrix.h"
+#include "mapped_file.h"
+#include "tokenizer.h"
+#include "parallel.h"
+#include "binary_format.h"
+#include "arena.h"
+#include "bit_set.h"
 
 #include <boost/algorithm/string.hpp>
 #include <boost/regex.hpp>
@@ -22,6 +28,14 @@
 #include <chrono>
 #include <sstream>
 #include <numeric>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+#include <optional>
+
+struct state_reduction; // see mc_analyzer.h
 
 /**
 	@brief Represents a morkov chain by storing edges with probabilities, with the possibility to store edge and state decorations.
@@ -37,18 +51,19 @@ public:
 
 private:
 
-	/// @brief This is the regex iterator for internal use. Always use boost::regex rather than  std::regex.
-	using regex_iterator = boost::regex_iterator<std::string::const_iterator>;
-
-	/// @brief Structure for storing one edge (markov chain transition).
+	/**
+		@brief Structure for storing one edge (markov chain transition).
+		@details Edges and their decoration slots live in \a edge_arena, they are never deleted individually. Create them by \a create_edge().
+	*/
 	struct edge {
 		_RationalT probability;
-		std::vector<_RationalT> decorations;
+		_RationalT* decorations; // n_edge_decorations slots in edge_arena
 
-		edge(const _RationalT& probability, const std::size_t& n_edge_decorations) : probability(probability), decorations(n_edge_decorations, 0) {}
+		edge(const _RationalT& probability, _RationalT* decorations) : probability(probability), decorations(decorations) {}
 	};
+	static_assert(std::is_trivially_destructible<_RationalT>::value, "Edges and their decorations are released in bulk without calling destructors.");
 
-	/// @brief Structure for storing one node (markov chain state).
+	/// @brief Structure for storing one node (markov chain state) of a markov chain that is not yet frozen.
 	struct node {
 		std::vector<_RationalT> decorations;
 
@@ -67,19 +82,549 @@ private:
 	/**
 		@brief Map to access transitions partitioned after first node.
 		@details Use semantics \a forward_transitions[from][to] to get a pointer to the desired edge.
-		When adding new edges, it is required to keep \a forward_transitions and \a inverse_transitions consistent.
+		There is no inverse map, predecessors are only available for frozen markov chains, see \a inverse_index().
 	*/
 	std::unordered_map<_IntegralT, std::unordered_map<_IntegralT, edge*>> forward_transitions;
-	/**
-		@brief Map to access transitions partitioned after second node.
-		@details Use semantics \a forward_transitions[to][from] to get a pointer to the desired edge.
-		When adding new edges, it is required to keep \a forward_transitions and \a inverse_transitions consistent.
-	*/
-	std::unordered_map<_IntegralT, std::unordered_map<_IntegralT, edge*>> inverse_transitions;
+
+	/// @brief Memory of all \a edge objects and their decoration slots. Released as a whole when freezing or destroying the markov chain.
+	arena edge_arena;
 
 	/// @brief Maps state id to associated node object containing decorations.
 	std::unordered_map<_IntegralT, node> states;
 
+	/**
+		@brief Contiguous compressed sparse row (CSR) representation of all transitions.
+		@details Transitions starting in state \a i are found at positions \a row_offsets[i] ... \a row_offsets[i+1]-1,
+		sorted by target state. \a edge_decorations[k][pos] is edge decoration \a k of the transition at position \a pos.
+	*/
+	struct csr_storage {
+		std::vector<std::size_t> row_offsets;
+		std::vector<_IntegralT> columns;
+		std::vector<_RationalT> probabilities;
+		std::vector<std::vector<_RationalT>> edge_decorations;
+	};
+
+	/**
+		@brief Transitions of a frozen markov chain.
+		@details Only valid if \a is_frozen. Then \a forward_transitions and \a states are empty.
+	*/
+	csr_storage csr;
+
+	/// @brief Number of states of a frozen markov chain. Internally its states are enumerated densely by 0, 1, ..., n_frozen_states-1.
+	std::size_t n_frozen_states;
+
+	/**
+		@brief Ids of the states of a frozen markov chain in ascending order, i.e. \a state_ids[i] is the id of dense state index \a i.
+		@details Empty if the ids are exactly 0, 1, ..., n_frozen_states-1, then id and dense index are the same.
+		Since the order of ids is kept, rows and columns of the CSR arrays are sorted by id as well.
+		Ids are only translated when reading or writing, see \a dense_index() and \a state_id().
+	*/
+	std::vector<_IntegralT> state_ids;
+
+	/**
+		@brief Node decorations of a frozen markov chain, one contiguous column per decoration index.
+		@details \a node_decorations[k][i] is node decoration \a k of state \a i. Like \a csr_storage::edge_decorations, this lets calculations stream over exactly the columns they need.
+	*/
+	std::vector<std::vector<_RationalT>> node_decorations;
+
+	/// @brief True if and only if the markov chain has been turned into its compact representation by \a freeze().
+	bool is_frozen;
+
+public:
+	/**
+		@brief Compressed sparse column (CSC) index of the transitions of a frozen markov chain, i.e. transitions grouped by target state.
+		@details Transitions ending in state \a j are found at positions \a column_offsets[j] ... \a column_offsets[j+1]-1, sorted by source state.
+		\a rows[k] is the source state, \a positions[k] the position of the transition in the CSR arrays, where its probability and decorations are found.
+	*/
+	struct csc_storage {
+		std::vector<std::size_t> column_offsets;
+		std::vector<_IntegralT> rows;
+		std::vector<std::size_t> positions;
+	};
+
+private:
+	/// @brief Predecessor index, built by the first call of \a inverse_index(). Empty until then.
+	mutable csc_storage csc;
+
+	/// @brief True if and only if \a csc has been built.
+	mutable bool has_csc;
+
+	/// @brief A transition as collected by bulk loaders before building the compact representation.
+	struct transition_entry {
+		_IntegralT from;
+		_IntegralT to;
+		_RationalT probability;
+	};
+
+	/**
+		@brief Assigns dense indices 0, 1, ..., n-1 to the state ids occurring in \a parts in ascending order of ids, stores the ids in \a state_ids and replaces all ids in \a parts by their dense indices.
+		@details Returns the number of states n. All ids must be less than \a id_bound.
+		If the ids are exactly 0, 1, ..., n-1, nothing is replaced and \a state_ids is left empty.
+		If \a id_bound is small compared to the number of transitions, ids are looked up in a direct table, otherwise by binary search in \a state_ids.
+	*/
+	std::size_t assign_dense_indices(const std::size_t& id_bound, std::vector<std::vector<transition_entry>>& parts) {
+		state_ids.clear();
+		const std::size_t n_transitions{ std::accumulate(parts.cbegin(), parts.cend(), std::size_t(0), [](const auto& sum, const auto& part) { return sum + part.size(); }) };
+
+		if (id_bound <= 2 * n_transitions + (1 << 16)) {
+			std::vector<char> occurs(id_bound, false);
+			for (const auto& part : parts)
+				for (const auto& t : part) {
+					occurs[static_cast<std::size_t>(t.from)] = true;
+					occurs[static_cast<std::size_t>(t.to)] = true;
+				}
+			if (std::all_of(occurs.cbegin(), occurs.cend(), [](const char& c) { return c; })) return id_bound;
+
+			std::vector<_IntegralT> dense_of_id(id_bound, 0);
+			for (std::size_t id{ 0 }; id < id_bound; ++id)
+				if (occurs[id]) {
+					dense_of_id[id] = static_cast<_IntegralT>(state_ids.size());
+					state_ids.push_back(static_cast<_IntegralT>(id));
+				}
+			run_in_parallel(parts.size(), [&](const std::size_t& i) {
+					for (auto& t : parts[i]) {
+						t.from = dense_of_id[static_cast<std::size_t>(t.from)];
+						t.to = dense_of_id[static_cast<std::size_t>(t.to)];
+					}
+				});
+			return state_ids.size();
+		}
+
+		// ids are sparse, collect and sort them:
+		state_ids.reserve(2 * n_transitions);
+		for (const auto& part : parts)
+			for (const auto& t : part) {
+				state_ids.push_back(t.from);
+				state_ids.push_back(t.to);
+			}
+		std::sort(state_ids.begin(), state_ids.end());
+		state_ids.erase(std::unique(state_ids.begin(), state_ids.end()), state_ids.end());
+		state_ids.shrink_to_fit();
+		run_in_parallel(parts.size(), [&](const std::size_t& i) {
+				for (auto& t : parts[i]) {
+					t.from = static_cast<_IntegralT>(std::lower_bound(state_ids.cbegin(), state_ids.cend(), t.from) - state_ids.cbegin());
+					t.to = static_cast<_IntegralT>(std::lower_bound(state_ids.cbegin(), state_ids.cend(), t.to) - state_ids.cbegin());
+				}
+			});
+		return state_ids.size();
+	}
+
+	/**
+		@brief Builds the compact representation of an empty markov chain directly from lists of transitions and marks it as frozen.
+		@details \a parts are transitions collected independently, e.g. by different threads. Transitions may be given in any order.
+		All state ids must be less than \a id_bound. States are those ids occurring in some transition, they get dense indices by \a assign_dense_indices().
+		\a parts are released while building.
+		\a decoration_parts[p] holds the edge decorations of transitions in \a parts[p], \a n_edge_decorations values per transition one after another.
+		If \a decoration_parts is empty, all edge decorations are initialized with zeros.
+		@exception std::invalid_argument Trying to add a transition that already exists.
+	*/
+	void build_frozen(const std::size_t& id_bound, std::vector<std::vector<transition_entry>>&& parts, std::vector<std::vector<_RationalT>>&& decoration_parts = {}) {
+		const std::size_t n_states{ assign_dense_indices(id_bound, parts) };
+
+		struct sorted_entry {
+			_IntegralT to;
+			_RationalT probability;
+			std::size_t origin; // position of the transition in the concatenation of all parts
+		};
+
+		// counting sort by source state:
+		std::vector<std::size_t> row_offsets(n_states + 1, 0);
+		for (const auto& part : parts)
+			for (const auto& t : part)
+				++row_offsets[static_cast<std::size_t>(t.from) + 1];
+		std::partial_sum(row_offsets.cbegin(), row_offsets.cend(), row_offsets.begin());
+		const std::size_t n_edges{ row_offsets.back() };
+		std::vector<sorted_entry> entries(n_edges);
+		{
+			std::vector<std::size_t> next(row_offsets.cbegin(), row_offsets.cend() - 1);
+			std::size_t origin{ 0 };
+			for (auto& part : parts) {
+				for (const auto& t : part)
+					entries[next[static_cast<std::size_t>(t.from)]++] = sorted_entry{ t.to, t.probability, origin++ };
+				std::vector<transition_entry>().swap(part);
+			}
+		}
+		std::vector<_RationalT> decorations;
+		for (auto& part : decoration_parts) {
+			if (decorations.empty()) decorations = std::move(part);
+			else decorations.insert(decorations.end(), part.cbegin(), part.cend());
+			std::vector<_RationalT>().swap(part);
+		}
+		if (!decorations.empty() && decorations.size() != n_edges * n_edge_decorations)
+			throw std::logic_error("Number of edge decorations does not match number of transitions.");
+
+		// sort each row by target state and detect duplicates, rows are split into independent ranges:
+		std::vector<_IntegralT> columns(n_edges);
+		std::vector<_RationalT> probabilities(n_edges);
+		std::vector<std::vector<_RationalT>> edge_decorations(n_edge_decorations, std::vector<_RationalT>(n_edges, 0));
+		const std::size_t n_tasks{ parallel_task_count(n_edges) };
+		run_in_parallel(n_tasks, [&](const std::size_t& task) {
+				const std::size_t rows_begin{ n_states * task / n_tasks };
+				const std::size_t rows_end{ n_states * (task + 1) / n_tasks };
+				for (std::size_t row{ rows_begin }; row < rows_end; ++row) {
+					const auto row_begin{ entries.begin() + row_offsets[row] };
+					const auto row_end{ entries.begin() + row_offsets[row + 1] };
+					std::sort(row_begin, row_end, [](const auto& l, const auto& r) { return l.to < r.to; });
+					if (std::adjacent_find(row_begin, row_end, [](const auto& l, const auto& r) { return l.to == r.to; }) != row_end)
+						throw std::invalid_argument("Trying to add a transition that already exists.");
+				}
+				for (std::size_t pos{ row_offsets[rows_begin] }; pos < row_offsets[rows_end]; ++pos) {
+					columns[pos] = entries[pos].to;
+					probabilities[pos] = entries[pos].probability;
+				}
+				if (!decorations.empty())
+					for (std::size_t k{ 0 }; k < n_edge_decorations; ++k)
+						for (std::size_t pos{ row_offsets[rows_begin] }; pos < row_offsets[rows_end]; ++pos)
+							edge_decorations[k][pos] = decorations[entries[pos].origin * n_edge_decorations + k];
+			});
+
+		csr.row_offsets = std::move(row_offsets);
+		csr.columns = std::move(columns);
+		csr.probabilities = std::move(probabilities);
+		csr.edge_decorations = std::move(edge_decorations);
+		n_frozen_states = n_states;
+		node_decorations.assign(n_node_decorations, std::vector<_RationalT>(n_states, 0));
+		is_frozen = true;
+	}
+
+	/**
+		@brief Splits the body of a prism file, i.e. everything behind the header line, into chunks of whole lines for parallel parsing.
+		@details Small files are not split.
+	*/
+	static std::vector<const char*> split_prism_body(const char* first, const char* last) {
+		return split_into_line_chunks(first, last, parallel_task_count(static_cast<std::size_t>(last - first), 1 << 20));
+	}
+
+	/**
+		@brief Matches the whole range against \a regxc::prism_file_format and prints the result.
+		@details Returns true if the range is well-formed or if boost::regex gave up with std::runtime_error.
+	*/
+	static bool check_prism_file_format(const char* first, const char* last) {
+		try {
+			const auto valid_file_format{ boost::regex_match(first, last, regxc::prism_file_format) };
+			std::cout << "Check for well-formed file format: " << interprete_bool_n(valid_file_format);
+			return valid_file_format;
+		}
+		catch (const std::runtime_error& e) {
+			std::cout << "WARNING: Could not check for well-formed file format. boost::regex throwed std::runtime_error:\n\t\t" << e.what() << "\n";
+		}
+		return true;
+	}
+
+	/**
+		@brief Reads the header line of a prism file, consisting of the number of states and the number of transitions.
+		@details Afterwards \a cursor points to the beginning of the first value line.
+	*/
+	static std::pair<unsigned long long, unsigned long long> read_prism_header(text_cursor& cursor) {
+		cursor.skip_whitespace();
+		unsigned long long n_states{ 0 };
+		unsigned long long n_transitions{ 0 };
+		if (!cursor.read_unsigned(n_states)) throw std::logic_error("Could not find number of states in header line.");
+		if (!cursor.read_unsigned(n_transitions)) throw std::logic_error("Could not find number of transitions in header line.");
+		cursor.skip_blanks();
+		if (!cursor.at_line_end()) throw std::logic_error("Could not find end of the header line.");
+		cursor.skip_line_break();
+		return std::make_pair(n_states, n_transitions);
+	}
+
+	/**
+		@brief Calls \a callback(from, to, value) for each value line "{from} {to} {value}" of a prism file, skipping blank lines.
+		@exception std::invalid_argument \a wrong_number (with line number appended) if a line does not contain exactly 3 numbers.
+	*/
+	template<class _Callback>
+	static void for_each_prism_value_line(text_cursor& cursor, const char* wrong_number, _Callback&& callback) {
+		while (!cursor.at_end()) {
+			cursor.skip_blanks();
+			if (cursor.at_line_end()) {
+				cursor.skip_line_break();
+				continue;
+			}
+			unsigned long long from{ 0 };
+			unsigned long long to{ 0 };
+			double value{ 0 };
+			const bool complete_line{ cursor.read_unsigned(from) && cursor.read_unsigned(to) && cursor.read_float(value) };
+			cursor.skip_blanks();
+			if (!complete_line || !cursor.at_line_end())
+				throw std::invalid_argument(std::string(wrong_number) + " (line " + std::to_string(cursor.line_number()) + ")");
+			cursor.skip_line_break();
+			callback(from, to, value);
+		}
+	}
+
+	/**
+		@brief Parses prism transitions from the character range [ \a first, \a last ), see \a read_transitions_from_prism_file.
+		@details The lines behind the header are parsed in parallel chunks, each into its own transition buffer.
+	*/
+	void read_transitions_from_prism_range(const char* first, const char* last, bool strict) {
+		auto d = make_surround_log("Building markov chain from prism transitions file");
+		if (!empty()) throw std::logic_error("Forbidden to read transitions from file if markov chain is not empty.");
+		if (strict && !check_prism_file_format(first, last)) throw std::invalid_argument("The input is maleformed.");
+
+		text_cursor cursor(first, last);
+		const auto header{ read_prism_header(cursor) };
+		const auto& n_states{ header.first };
+		const auto& n_transitions{ header.second };
+
+		const auto chunks{ split_prism_body(cursor.position(), last) };
+		const std::size_t n_chunks{ chunks.size() - 1 };
+		const double body_size{ static_cast<double>(last - cursor.position()) };
+		std::vector<std::vector<transition_entry>> parts(n_chunks);
+		std::vector<std::size_t> n_states_found(n_chunks, 0);
+		run_in_parallel(n_chunks, [&](const std::size_t& i) {
+				const std::size_t chunk_size{ static_cast<std::size_t>(chunks[i + 1] - chunks[i]) };
+				// reserve the chunk's share of the header count, but a value line has at least 6 characters, so a wrong header cannot trigger a huge allocation:
+				parts[i].reserve(static_cast<std::size_t>(std::min(static_cast<double>(n_transitions) * chunk_size / body_size + 1, chunk_size / 6.0 + 1)));
+				text_cursor chunk_cursor(first, chunks[i], chunks[i + 1]);
+				for_each_prism_value_line(chunk_cursor, "Found a transition line which does not contain exactly 3 numbers.",
+					[&](const unsigned long long& from, const unsigned long long& to, const double& probability) {
+						//## cast prob here!! We need custom striung to int/double in case someone chooses custom types.
+						parts[i].push_back(transition_entry{ static_cast<_IntegralT>(from), static_cast<_IntegralT>(to), probability });
+						n_states_found[i] = std::max(n_states_found[i], static_cast<std::size_t>(std::max(from, to)) + 1);
+					});
+			});
+		const std::size_t count_transitions{ std::accumulate(parts.cbegin(), parts.cend(), std::size_t(0), [](const auto& sum, const auto& part) { return sum + part.size(); }) };
+
+		if (count_transitions == 0) {
+			std::cout << "WARNING: Created markov chain is still empty.\n";
+			if (n_states != 0) std::cout << "WARNING: Number of states in header line is wrong.\n";
+			if (n_transitions != 0) std::cout << "WARNING: Number of transitions in header line is wrong.\n";
+			return;
+		}
+		build_frozen(*std::max_element(n_states_found.cbegin(), n_states_found.cend()), std::move(parts));
+
+		// all states occur in some transition:
+		if (n_states != n_frozen_states)
+			std::cout << "WARNING: Number of states in header line is wrong.\n";
+		if (n_transitions != count_transitions)
+			std::cout << "WARNING: Number of transitions in header line is wrong.\n";
+	}
+
+	/**
+		@brief Parses prism rewards from the character range [ \a first, \a last ), see \a read_rewards_from_prism_file.
+		@details For a frozen markov chain the lines behind the header are parsed in parallel chunks.
+		Rewards are then written in file order, so replaced rewards are reported as if the file had been read sequentially.
+	*/
+	void read_rewards_from_prism_range(const char* first, const char* last, const std::size_t& index_of_reward, bool strict) {
+		if (!(index_of_reward < n_edge_decorations)) throw std::logic_error("Markov chain has not enough space for rewards. You need to specify number of rewards at construction or add edge decorations with add_edge_deco.");
+		auto d = make_surround_log("Adding rewards to markov chain, reading from prism rewards file");
+		if (strict && !check_prism_file_format(first, last)) throw std::invalid_argument("The file is not well-formed.");
+
+		text_cursor cursor(first, last);
+		read_prism_header(cursor);
+		const auto wrong_number{ "Found a reward line which does not contain exactly 3 numbers." };
+
+		if (is_frozen) {
+			const auto chunks{ split_prism_body(cursor.position(), last) };
+			const std::size_t n_chunks{ chunks.size() - 1 };
+			std::vector<std::vector<std::pair<std::size_t, _RationalT>>> parts(n_chunks);
+			run_in_parallel(n_chunks, [&](const std::size_t& i) {
+					text_cursor chunk_cursor(first, chunks[i], chunks[i + 1]);
+					for_each_prism_value_line(chunk_cursor, wrong_number,
+						[&](const unsigned long long& from, const unsigned long long& to, const double& reward) {
+							const auto pos{ find_frozen_edge(static_cast<_IntegralT>(from), static_cast<_IntegralT>(to)) };
+							if (pos == csr.columns.size())
+								throw std::invalid_argument("File defines reward for some non-existent edge.");
+							parts[i].emplace_back(pos, reward);
+						});
+				});
+			auto& rewards{ csr.edge_decorations[index_of_reward] };
+			for (const auto& part : parts)
+				for (const auto& entry : part) {
+					if (rewards[entry.first])
+						std::cout << "WARNING: Reward gets replaced.\n";
+					rewards[entry.first] = entry.second;
+				}
+			return;
+		}
+
+		for_each_prism_value_line(cursor, wrong_number,
+			[&](const unsigned long long& from, const unsigned long long& to, const double& reward) {
+				const auto row{ forward_transitions.find(static_cast<_IntegralT>(from)) };
+				if (row == forward_transitions.end())
+					throw std::invalid_argument("File defines reward for some non-existent edge.");
+				const auto entry{ row->second.find(static_cast<_IntegralT>(to)) };
+				if (entry == row->second.end())
+					throw std::invalid_argument("File defines reward for some non-existent edge.");
+
+				if (entry->second->decorations[index_of_reward])
+					std::cout << "WARNING: Reward gets replaced.\n";
+				entry->second->decorations[index_of_reward] = reward; //##!! cast here!!
+				// attention: requires each edge to appear once
+			});
+	}
+
+	/// @brief Parses a general markov chain from the character range [ \a first, \a last ), see \a read_from_gmc_file.
+	void read_from_gmc_range(const char* first, const char* last, bool strict) {
+		auto d = make_surround_log("Building markov chain from gmc file");
+		if (!empty()) throw std::logic_error("Forbidden to read transitions from file if markov chain is not empty.");
+
+		// Check for overall format:
+		if (strict) {
+			try {
+				if (!boost::regex_match(first, last, regxc::gmc_general))
+					throw std::invalid_argument("No valid GENERAL MARKOV CHAIN format");
+				else std::cout << "General syntax: okay.\n";
+			}
+			catch (const std::runtime_error& e) {
+				std::cout << "WARNING: Could not check for well-formed file format. boost::regex throwed std::runtime_error:\n\t\t" << e.what() << "\n";
+			}
+		}
+
+		// Skip comment lines in front of the semantics definition:
+		text_cursor cursor(first, last);
+		cursor.skip_whitespace();
+		while (cursor.peek('#')) {
+			cursor.skip_line();
+			cursor.skip_whitespace();
+		}
+
+		// Extract column names:
+		const auto no_semantics_definition{ "Syntax error: did not find exactly one semantics defintion." };
+		std::vector<std::string> column_names;
+		do {
+			const auto name{ cursor.read_token() };
+			const auto is_word_character{ [](const char& c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; } };
+			if (name.size() < 2 || name.front() != '$' || !std::all_of(name.cbegin() + 1, name.cend(), is_word_character))
+				throw std::invalid_argument(no_semantics_definition);
+			column_names.push_back(name);
+		} while (cursor.consume(','));
+		cursor.skip_blanks();
+		if (!cursor.at_line_end()) throw std::invalid_argument(no_semantics_definition);
+		cursor.skip_line_break();
+		const char* semantics_definition_end{ cursor.position() };
+
+		std::cout << "Column names: " << column_names.size() << std::endl;
+		for (const auto& name : column_names) std::cout << name << "\n";
+
+		// Resolve column layout once:
+		enum class column_kind { from, to, probability, decoration };
+		const std::size_t n_columns{ column_names.size() };
+		std::vector<column_kind> column_kinds(n_columns, column_kind::decoration);
+		std::vector<std::size_t> decoration_of_column(n_columns, 0);
+		std::vector<bool> decoration_defined(n_edge_decorations, false);
+		bool has_from{ false }, has_to{ false }, has_prob{ false };
+		for (std::size_t i{ 0 }; i < n_columns; ++i) {
+			const auto& name{ column_names[i] };
+			const auto defined_twice{ "Column " + name + " is defined twice." };
+			if (name == "$from") {
+				if (has_from) throw std::invalid_argument(defined_twice);
+				column_kinds[i] = column_kind::from;
+				has_from = true;
+				continue;
+			}
+			if (name == "$to") {
+				if (has_to) throw std::invalid_argument(defined_twice);
+				column_kinds[i] = column_kind::to;
+				has_to = true;
+				continue;
+			}
+			if (name == "$prob") {
+				if (has_prob) throw std::invalid_argument(defined_twice);
+				column_kinds[i] = column_kind::probability;
+				has_prob = true;
+				continue;
+			}
+			std::size_t index{ 0 };
+			const auto result{ std::from_chars(name.data() + 1, name.data() + name.size(), index) };
+			if (result.ec != std::errc() || result.ptr != name.data() + name.size() || !(index < n_edge_decorations))
+				throw std::invalid_argument("Column " + name + " does not name a valid edge decoration index.");
+			if (decoration_defined[index]) throw std::invalid_argument(defined_twice);
+			decoration_defined[index] = true;
+			decoration_of_column[i] = index;
+		}
+		if (!has_from) throw std::invalid_argument("No $from column");
+		if (!has_to) throw std::invalid_argument("No $to column");
+		if (!has_prob) throw std::invalid_argument("No $prob column");
+
+		//check all other lines for being in right format (wellformed body)
+		if (strict) {
+			const auto gmc_s_value_format{ std::string(R"([+-]?([0-9]*[.])?[0-9]+)") };
+			const auto gmc_s_separator{ std::string(R"(\s*,\s*)") };
+			auto gmc_s_value_definition_line{ std::string() };
+			for (std::size_t i = 0; i < n_columns - 1; ++i) (gmc_s_value_definition_line += gmc_s_value_format) += gmc_s_separator;
+			gmc_s_value_definition_line += gmc_s_value_format;
+			const auto gmc_value_definition_body{ boost::regex(
+				std::string("((") + regex_strings::native_ignored + "|" + gmc_s_value_definition_line + ")?(" + regex_strings::new_line + "|$))*"
+			) };
+			try {
+				std::cout << "Check for wellformed body: " <<
+					interprete_bool_n(boost::regex_match(semantics_definition_end, last, gmc_value_definition_body));
+			}
+			catch (const std::runtime_error& e) {
+				std::cout << "WARNING: Could not check for wellformed body. boost::regex throwed std::runtime_error:\n\t\t" << e.what() << "\n";
+			}
+		}
+
+		//read all lines of body:
+		std::vector<transition_entry> transitions;
+		std::vector<_RationalT> decorations;
+		std::size_t n_states{ 0 };
+		while (!cursor.at_end()) {
+			cursor.skip_blanks();
+			if (cursor.at_line_end()) {
+				cursor.skip_line_break();
+				continue;
+			}
+			if (cursor.peek('#')) {
+				cursor.skip_line();
+				continue;
+			}
+			if (cursor.peek('$')) throw std::invalid_argument(no_semantics_definition);
+
+			// for each line defining some edge
+			unsigned long long from{ 0 }, to{ 0 };
+			double probability{ 0 };
+			const std::size_t decorations_begin{ decorations.size() };
+			decorations.resize(decorations_begin + n_edge_decorations, 0);
+			bool complete_line{ true };
+			for (std::size_t i{ 0 }; complete_line && i < n_columns; ++i) {
+				if (i > 0 && !cursor.consume(',')) {
+					complete_line = false;
+					break;
+				}
+				switch (column_kinds[i]) {
+				case column_kind::from:
+					complete_line = cursor.read_unsigned(from);
+					break;
+				case column_kind::to:
+					complete_line = cursor.read_unsigned(to);
+					break;
+				case column_kind::probability:
+					complete_line = cursor.read_float(probability);
+					break;
+				case column_kind::decoration: {
+					double reward{ 0 };
+					complete_line = cursor.read_float(reward);
+					decorations[decorations_begin + decoration_of_column[i]] = reward;
+					break;
+				}
+				}
+			}
+			cursor.skip_blanks();
+			if (!complete_line || !cursor.at_line_end())
+				throw std::invalid_argument("Could not read some parameter (line " + std::to_string(cursor.line_number()) + ")");
+			cursor.skip_line_break();
+
+			transitions.push_back(transition_entry{ static_cast<_IntegralT>(from), static_cast<_IntegralT>(to), probability });
+			n_states = std::max(n_states, static_cast<std::size_t>(std::max(from, to)) + 1);
+		}
+		if (transitions.empty()) return;
+
+		std::vector<std::vector<transition_entry>> parts;
+		parts.push_back(std::move(transitions));
+		std::vector<std::vector<_RationalT>> decoration_parts;
+		decoration_parts.push_back(std::move(decorations));
+		build_frozen(n_states, std::move(parts), std::move(decoration_parts));
+	}
+
+	/**
+		@brief Creates an edge with given \a probability and all decorations set to zero in \a edge_arena.
+		@details The edge still needs to be inserted into \a forward_transitions.
+	*/
+	edge* create_edge(const _RationalT& probability) {
+		return edge_arena.create<edge>(probability, edge_arena.create_array<_RationalT>(n_edge_decorations, _RationalT(0)));
+	}
+
 	/**
 		@brief Initializes a state with a decoration vector containing zeros.
 		@details The node's decoration vector uses size defined by \a n_node_decorations.
@@ -99,24 +644,38 @@ public:
 		n_edge_decorations(n_edge_decorations),
 		n_node_decorations(n_node_decorations),
 		forward_transitions(),
-		inverse_transitions(),
-		states()
+		edge_arena(),
+		states(),
+		csr(),
+		n_frozen_states(0),
+		state_ids(),
+		node_decorations(),
+		is_frozen(false),
+		csc(),
+		has_csc(false)
 	{
 	}
 
 	/// @brief Returns true if and only if there are no states and no transitions.
 	bool empty() const noexcept {
-		// Consistency implies that both transition operands are the same:
-		return forward_transitions.empty() && inverse_transitions.empty() && states.empty();
+		if (is_frozen) return n_frozen_states == 0 && csr.columns.empty();
+		return forward_transitions.empty() && states.empty();
+	}
+
+	/// @brief Returns true if and only if the markov chain has been turned into its compact representation by \a freeze().
+	bool frozen() const noexcept {
+		return is_frozen;
 	}
 
 	/// @brief Returns the number of states in the markov chain.
 	auto size_states() const noexcept -> decltype(states.size()) {
+		if (is_frozen) return n_frozen_states;
 		return states.size();
 	}
 
 	/// @brief Returns the number of edges in the markov chain.
 	auto size_edges() const noexcept -> decltype(forward_transitions.size()){
+		if (is_frozen) return csr.columns.size();
 		return std::accumulate(
 			forward_transitions.cbegin(),
 			forward_transitions.cend(),
@@ -126,303 +685,497 @@ public:
 	}
 
 	/**
-		@brief Reads a prism transitions file to build up a markov chain.
-		@details The markov chain must be empty before reading file.
-		@exception std::invalid_argument Bad stream.
-		@exception std::logic_error Forbidden to read transitions from file if markov chain is not empty.
-		@exception std::invalid_argument The input is maleformed.
-		@exception std::logic_error Could not find end of the header line.
-		@expetion std::logic_error Could not find number of states in header line.
-		@exception std::logic_error Could not find number of transitions in header line.
-		@details some excpetions not yet documented. ###
+		@brief Turns the markov chain into its compact representation.
+		@details All transitions are moved into contiguous CSR arrays (see \a csr_storage), edge decorations into one array per decoration index
+		and nodes into an array indexed by dense state index. States get dense indices in ascending order of their ids, see \a state_ids.
+		All edge objects and hash maps are released.
+		Afterwards no more transitions can be added, but decorations can still be read and written.
+		Calling \a freeze() on an already frozen or on an empty markov chain has no effect.
 	*/
-	void read_transitions_from_prism_file(std::istream& transitions) {
-		auto d = make_surround_log("Building markov chain from prism transitions file");
-		if (!transitions.good()) throw std::invalid_argument("Bad stream.");
-		if (!empty()) throw std::logic_error("Forbidden to read transitions from file if markov chain is not empty.");
+	void freeze() {
+		if (is_frozen || empty()) return;
+		auto d = make_surround_log("Freezing markov chain into compact representation");
+
+		const std::size_t n_states{ states.size() };
+		state_ids.clear();
+		for (const auto& pair : states)
+			if (!(static_cast<std::size_t>(pair.first) < n_states)) {
+				// ids are not contiguous:
+				state_ids.reserve(n_states);
+				for (const auto& state : states) state_ids.push_back(state.first);
+				std::sort(state_ids.begin(), state_ids.end());
+				break;
+			}
+		std::unordered_map<_IntegralT, _IntegralT> dense_of_id;
+		if (!state_ids.empty())
+			for (std::size_t i{ 0 }; i < n_states; ++i) dense_of_id.emplace(state_ids[i], static_cast<_IntegralT>(i));
+		const auto dense{ [&](const _IntegralT& id) { return state_ids.empty() ? id : dense_of_id.at(id); } };
+
+		// count transitions per row:
+		csr.row_offsets.assign(n_states + 1, 0);
+		for (const auto& row : forward_transitions)
+			csr.row_offsets[static_cast<std::size_t>(dense(row.first)) + 1] = row.second.size();
+		std::partial_sum(csr.row_offsets.cbegin(), csr.row_offsets.cend(), csr.row_offsets.begin());
+
+		const std::size_t n_edges{ csr.row_offsets.back() };
+		csr.columns.resize(n_edges);
+		csr.probabilities.resize(n_edges);
+		csr.edge_decorations.assign(n_edge_decorations, std::vector<_RationalT>(n_edges));
+
+		// fill rows sorted by target state:
+		std::vector<std::pair<_IntegralT, edge*>> row_buffer;
+		for (const auto& row : forward_transitions) {
+			row_buffer.assign(row.second.cbegin(), row.second.cend());
+			std::sort(row_buffer.begin(), row_buffer.end(), [](const auto& l, const auto& r) { return l.first < r.first; });
+			std::size_t pos{ csr.row_offsets[static_cast<std::size_t>(dense(row.first))] };
+			for (const auto& entry : row_buffer) {
+				csr.columns[pos] = dense(entry.first);
+				csr.probabilities[pos] = entry.second->probability;
+				for (std::size_t k{ 0 }; k < n_edge_decorations; ++k)
+					csr.edge_decorations[k][pos] = entry.second->decorations[k];
+				++pos;
+			}
+		}
 
-		// Read the whole input into a string
-		transitions.unsetf(std::ios_base::skipws); // also recognize new lines and spaces
-		const auto input_s{ std::string(std::istream_iterator<char>(transitions),std::istream_iterator<char>()) };
+		n_frozen_states = n_states;
+		node_decorations.assign(n_node_decorations, std::vector<_RationalT>(n_states));
+		for (const auto& pair : states)
+			for (std::size_t k{ 0 }; k < n_node_decorations; ++k)
+				node_decorations[k][static_cast<std::size_t>(dense(pair.first))] = pair.second.decorations[k];
+
+		// release the hash based representation:
+		decltype(forward_transitions)().swap(forward_transitions);
+		decltype(states)().swap(states);
+		edge_arena.release();
+		is_frozen = true;
+	}
 
-		// check overall file format
-		try {
-			const auto valid_file_format{ boost::regex_match(input_s, regxc::prism_file_format) }; //### may produce runtime error -> in case the fi9le does not match -> check if chosen regexes have some kind of structure where runtime state-set of emulating NFA may explode.
-			std::cout << "Check for well-formed file format: " << interprete_bool_n(valid_file_format);
-			if (!valid_file_format) throw std::invalid_argument("The input is maleformed.");
-		}
-		catch (const std::runtime_error & e) {
-			std::cout << "WARNING: Could not check for well-formed file format. boost::regex throwed std::runtime_error:\n\t\t" << e.what() << "\n";
-		}
+	/// @brief Returns the number of decoration values of each edge.
+	std::size_t size_edge_decorations() const noexcept {
+		return n_edge_decorations;
+	}
 
-		// find end of header line
-		const auto regx_it_prism_header_transitions{ regex_iterator(input_s.cbegin(),input_s.cend(),regxc::prism_header) };
-		const auto exists_header_line{ regx_it_prism_header_transitions != regex_iterator() };
-		if (!exists_header_line) throw std::logic_error("Could not find end of the header line.");
-		const std::string::const_iterator transitions_header_begin{ regx_it_prism_header_transitions->operator[](0).first };
-		const std::string::const_iterator transitions_header_end{ regx_it_prism_header_transitions->operator[](0).second };
-
-		// store number of states and number of transitions
-		regex_iterator header_iterator{ regex_iterator(transitions_header_begin, transitions_header_end, regxc::nonnegative_integer) };
-		auto s = std::string(transitions_header_begin, transitions_header_end);
-		if (header_iterator == regex_iterator()) throw std::logic_error("Could not find number of states in header line.");
-		const auto n_states{ std::stoull(header_iterator->str()) };
-		++header_iterator;
-		if (header_iterator == regex_iterator()) throw std::logic_error("Could not find number of transitions in header line.");
-		const auto n_transitions{ std::stoull(header_iterator->str()) };
-		//using c = std::remove_const<decltype(n_transitions)>::type;
-		std::size_t count_transitions{ 0 }; //### use type c!
-
-		// iterate all lines that define edges of the markov chain
-		for (auto it = regex_iterator(transitions_header_end, input_s.cend(), regxc::prism_value_line); it != regex_iterator(); ++it) {
-			auto jt = regex_iterator(it->operator[](0).first, it->operator[](0).second, regxc::nn_float);
-			const auto wrong_number{ "Found a transition line which does not contain exactly 3 numbers." };
-
-			if (jt == regex_iterator()) throw std::invalid_argument(wrong_number);
-			const auto from{ std::stoull(jt->str(0)) };
-
-			++jt;
-			if (jt == regex_iterator()) throw std::invalid_argument(wrong_number);
-			const auto to{ std::stoull(jt->str(0)) };
-
-			++jt;
-			if (jt == regex_iterator()) throw std::invalid_argument(wrong_number);
-			const double probability{ std::stod(jt->str(0)) };
-
-			++jt;
-			if (jt != regex_iterator()) throw std::invalid_argument(wrong_number);
-
-			if (forward_transitions[from].find(to) != forward_transitions[from].end())
-				throw std::invalid_argument("Trying to add a transition that already exists.");
-
-			//## cast prob here!! We need custom striung to int/double in case someone chooses custom types.
-			auto ptr{ new edge(probability, n_edge_decorations) };
-			inverse_transitions[to][from] = forward_transitions[from][to] = ptr;
-			++count_transitions;
-
-			init_state(from);
-			init_state(to);
-		}
-		if (empty()) std::cout << "WARNING: Created markov chain is still empty.\n";
-		if (n_states != states.size())
-			std::cout << "WARNING: Number of states in header line is wrong.\n";
-		if (n_transitions != count_transitions)
-			std::cout << "WARNING: Number of transitions in header line is wrong.\n";
+	/// @brief Returns the number of decoration values of each node.
+	std::size_t size_node_decorations() const noexcept {
+		return n_node_decorations;
 	}
 
 	/**
-		@brief Reads a prism rewards file to build up a markov chain.
-		@details Checks whether the markov chain has all the transitions that rewards are defined for in given file.
-		@details Not all exceptions deocumented yet ###
+		@brief Appends \a count edge decoration columns initialized with zeros. Existing decorations keep their indices.
+		@details The markov chain is frozen first (see \a freeze()), then only columns are added, the transitions are not touched.
+		On an empty markov chain, only the number of decorations of edges added later is changed.
 	*/
-	void read_rewards_from_prism_file(std::istream& rewards, const std::size_t& index_of_reward = 0) {
-		if (!rewards.good()) throw std::invalid_argument("Bad stream.");
-		if (!(index_of_reward < n_edge_decorations)) throw std::logic_error("Markov chain has not enough space for rewards. You need to specify number of rewards at construction. Adding more rewards dynamically is not yet implemented.");
-		auto d = make_surround_log("Adding rewards to markov chain, reading from prism rewards file");
-		// read input to string
-		rewards.unsetf(std::ios_base::skipws);
-		const auto input_s{ std::string(std::istream_iterator<char>(rewards),std::istream_iterator<char>()) };
+	void add_edge_decorations(const std::size_t& count = 1) {
+		freeze();
+		if (is_frozen) csr.edge_decorations.resize(n_edge_decorations + count, std::vector<_RationalT>(csr.columns.size(), 0));
+		n_edge_decorations += count;
+	}
 
-		// check overall file format
-		try {
-			const auto valid_file_format{ boost::regex_match(input_s, regxc::prism_file_format) };
-			std::cout << "Check for well-formed file format: " << interprete_bool_n(valid_file_format);
-			if (!valid_file_format) throw std::invalid_argument("The file is not well-formed.");
-		}
-		catch (const std::runtime_error & e) {
-			std::cout << "WARNING: Could not check for well-formed file format. boost::regex throwed std::runtime_error:\n\t\t" << e.what() << "\n";
-		}
-		// find end of header line
-		const auto regx_it_prism_header_rewards{ regex_iterator(input_s.cbegin(),input_s.cend(),regxc::prism_header) };
-		const auto exists_header_line{ regx_it_prism_header_rewards != regex_iterator() };
-		if (!exists_header_line) throw std::logic_error("Could not find end of the header line.");
-		std::string::const_iterator rewards_header_end{ regx_it_prism_header_rewards->operator[](0).second };
-
-		// iterate all lines that define rewards of the markov chain
-		for (auto it = regex_iterator(rewards_header_end, input_s.cend(), regxc::prism_value_line); it != regex_iterator(); ++it) {
-			auto jt = regex_iterator(it->operator[](0).first, it->operator[](0).second, regxc::nn_float);
-			const auto wrong_number{ "Found a reward line which does not contain exactly 3 numbers." };
-
-			if (jt == regex_iterator()) throw std::invalid_argument(wrong_number);
-			const unsigned long from{ std::stoul(jt->str(0)) };
-
-			++jt;
-			if (jt == regex_iterator()) throw std::invalid_argument(wrong_number);
-			unsigned long to{ std::stoul(jt->str(0)) };
-
-			++jt;
-			if (jt == regex_iterator()) throw std::invalid_argument(wrong_number);
-			double reward{ std::stod(jt->str(0)) };
-
-			++jt;
-			if (jt != regex_iterator()) throw std::invalid_argument(wrong_number);
-
-			if (forward_transitions[from].find(to) == forward_transitions[from].end())
-				throw std::invalid_argument("File defines reward for some non-existent edge.");
-
-			if (forward_transitions[from][to]->decorations[index_of_reward])
-				std::cout << "WARNING: Reward gets replaced.\n";
-			forward_transitions[from][to]->decorations[index_of_reward] = reward; //##!! cast here!!
-			// attention: requires each edge to appear once
-		}
+	/**
+		@brief Removes the edge decoration column at \a index. Decorations at greater indices move down by one.
+		@details The markov chain is frozen first (see \a freeze()), then only columns are removed, the transitions are not touched.
+		@exception std::out_of_range There is no edge decoration at given index.
+	*/
+	void drop_edge_decoration(const std::size_t& index) {
+		if (!(index < n_edge_decorations)) throw std::out_of_range("There is no edge decoration at given index.");
+		freeze();
+		if (is_frozen) csr.edge_decorations.erase(csr.edge_decorations.begin() + index);
+		--n_edge_decorations;
 	}
 
 	/**
-		@brief Reads a general markov chain file and builds up the corresponding markov chain as object.
-		@details provide more details here ##
+		@brief Appends \a count node decoration columns initialized with zeros. Existing decorations keep their indices.
+		@details The markov chain is frozen first (see \a freeze()).
 	*/
-	void read_from_gmc_file(std::istream& input) {
-		/// rename all identifiers here!
-		auto& test_file_stream{ input };
-		if (!input.good()) throw std::invalid_argument("Bad stream.");
-		test_file_stream.unsetf(std::ios_base::skipws); // also recognize new lines and spaces
-		auto d = make_surround_log("Building markov chain from gmc file");
+	void add_node_decorations(const std::size_t& count = 1) {
+		freeze();
+		if (is_frozen) node_decorations.resize(n_node_decorations + count, std::vector<_RationalT>(n_frozen_states, 0));
+		n_node_decorations += count;
+	}
+
+	/**
+		@brief Removes the node decoration column at \a index. Decorations at greater indices move down by one.
+		@details The markov chain is frozen first (see \a freeze()).
+		@exception std::out_of_range There is no node decoration at given index.
+	*/
+	void drop_node_decoration(const std::size_t& index) {
+		if (!(index < n_node_decorations)) throw std::out_of_range("There is no node decoration at given index.");
+		freeze();
+		if (is_frozen) node_decorations.erase(node_decorations.begin() + index);
+		--n_node_decorations;
+	}
 
-		//rename::
-		const auto test_file_string{ std::string(std::istream_iterator<char>(static_cast<std::istream&>(test_file_stream)),std::istream_iterator<char>()) };
+	/**
+		@brief Returns the dense index of the state with given \a id in a frozen markov chain, or \a size_states() if there is no such state.
+		@details Constant time if ids are contiguous, otherwise a binary search in \a state_ids.
+	*/
+	std::size_t dense_index(const _IntegralT& id) const {
+		if (state_ids.empty()) return static_cast<std::size_t>(id) < n_frozen_states ? static_cast<std::size_t>(id) : n_frozen_states;
+		const auto it{ std::lower_bound(state_ids.cbegin(), state_ids.cend(), id) };
+		if (it == state_ids.cend() || *it != id) return n_frozen_states;
+		return it - state_ids.cbegin();
+	}
 
-		// describing formal "general markov chain"
-		const auto gmc_s_new_line{ regex_strings::new_line };
-		const auto gmc_s_irgnored_line{ regex_strings::native_ignored };
-		auto gmc_general{ regxc::gmc_general };
+	/// @brief Returns the id of the state with dense index \a index in a frozen markov chain.
+	_IntegralT state_id(const std::size_t& index) const {
+		return state_ids.empty() ? static_cast<_IntegralT>(index) : state_ids[index];
+	}
 
-		// Check for overall format:
-		
-		try {
-		if (!boost::regex_match(test_file_string, regxc::gmc_general))
-			throw std::invalid_argument("No valid GENERAL MARKOV CHAIN format");
-			else std::cout << "General syntax: okay.\n";
-		}
-		catch (const std::runtime_error & e) {
-			std::cout << "WARNING: Could not check for well-formed file format. boost::regex throwed std::runtime_error:\n\t\t" << e.what() << "\n";
+	/**
+		@brief Translates a set of state ids into the set of dense indices of these states in a frozen markov chain.
+		@details Ids of states that do not exist in the markov chain are dropped. All calculations work on dense indices.
+	*/
+	template<class _Set>
+	_Set dense_state_set(const _Set& ids) const {
+		_Set result;
+		result.reserve(ids.size());
+		for (const auto& id : ids) {
+			const std::size_t index{ dense_index(static_cast<_IntegralT>(id)) };
+			if (index < n_frozen_states) result.insert(static_cast<typename _Set::value_type>(index));
 		}
-		
-		// Locate semantics defintion line:
-		const auto regx_it_semantics_definition{
-			regex_iterator(test_file_string.begin(),test_file_string.end(),regxc::gmc_semantics_definition)
-		};
-		if (std::distance(regx_it_semantics_definition, regex_iterator()) != 1) throw std::invalid_argument("Syntax error: did not find exactly one semantics defintion.");
-		std::string::const_iterator semantics_definition_begin{ regx_it_semantics_definition->operator[](0).first };
-		std::string::const_iterator semantics_definition_end{ regx_it_semantics_definition->operator[](0).second };
+		return result;
+	}
 
-		// Extract column names:
-		auto column_names_vector{ std::vector<std::pair<std::string::const_iterator,std::string::const_iterator>>() };
-		for (auto col_name_it{ regex_iterator(semantics_definition_begin, semantics_definition_end, regxc::gmc_column_name) };
-			col_name_it != regex_iterator(); ++col_name_it) {
-			column_names_vector.emplace_back(col_name_it->operator[](0).first, col_name_it->operator[](0).second);
-		}
-		std::cout << "Column names: " << column_names_vector.size() << std::endl; // necessary? <- and next lines:
-		for (const auto& pair : column_names_vector) {
-			for (auto it = pair.first; it != pair.second; ++it) std::cout << *it;
-			std::cout << "\n";
+	/**
+		@brief Translates a bitset of state ids into the bitset of dense indices of these states in a frozen markov chain, see \a dense_state_set().
+		@details No hashing: contiguous ids are copied word-wise, otherwise each state tests the bit of its id.
+	*/
+	bit_set<_IntegralT> dense_state_set(const bit_set<_IntegralT>& ids) const {
+		if (state_ids.empty()) {
+			bit_set<_IntegralT> result{ ids };
+			result &= bit_set<_IntegralT>::filled(n_frozen_states);
+			return result;
 		}
-		const auto sfrom{ std::string("$from") };
-		const auto sto{ std::string("$to") };
-		const auto sprob{ std::string("$prob") };
+		bit_set<_IntegralT> result(n_frozen_states);
+		for (std::size_t i{ 0 }; i < n_frozen_states; ++i)
+			if (ids.count(state_ids[i])) result.insert(static_cast<_IntegralT>(i));
+		return result;
+	}
 
-		std::vector<std::string> cnv;
-		std::transform(column_names_vector.cbegin(), column_names_vector.cend(), std::back_inserter(cnv), [](auto pair) {return std::string(pair.first, pair.second); });
+	/// @brief Returns the set of the ids of all states.
+	bit_set<_IntegralT> state_id_set() const {
+		if (is_frozen && state_ids.empty()) return bit_set<_IntegralT>::filled(n_frozen_states);
+		bit_set<_IntegralT> result;
+		if (is_frozen)
+			for (const auto& id : state_ids) result.insert(id);
+		else
+			for (const auto& pair : states) result.insert(pair.first);
+		return result;
+	}
 
-		const auto cfrom{ std::find(cnv.cbegin(), cnv.cend(), sfrom) };
-		const auto cto{ std::find(cnv.cbegin(), cnv.cend(), sto) };
-		const auto cprob{ std::find(cnv.cbegin(), cnv.cend(), sprob) };
+	/**
+		@brief Returns the position of transition \a from --> \a to (given by state ids) in the CSR arrays of a frozen markov chain.
+		@details Returns \a csr.columns.size() if there is no such transition.
+	*/
+	std::size_t find_frozen_edge(const _IntegralT& from, const _IntegralT& to) const {
+		const std::size_t row{ dense_index(from) };
+		const std::size_t column{ dense_index(to) };
+		if (!(row < n_frozen_states) || !(column < n_frozen_states)) return csr.columns.size();
+		const auto row_begin{ csr.columns.cbegin() + csr.row_offsets[row] };
+		const auto row_end{ csr.columns.cbegin() + csr.row_offsets[row + 1] };
+		const auto it{ std::lower_bound(row_begin, row_end, static_cast<_IntegralT>(column)) };
+		if (it == row_end || *it != static_cast<_IntegralT>(column)) return csr.columns.size();
+		return it - csr.columns.cbegin();
+	}
 
-		if (cfrom == cnv.cend()) throw std::invalid_argument("No $from column");
-		if (cto == cnv.cend()) throw std::invalid_argument("No $to column");
-		if (cprob == cnv.cend()) throw std::invalid_argument("No $prob column");
+	/**
+		@brief Returns the predecessor index of a frozen markov chain in CSC form, see \a csc_storage.
+		@details The index is built by a counting sort over the CSR arrays on the first call, O(states + transitions), and kept until \a release_inverse_index().
+		Markov chains that never ask for predecessors do not pay for it. Building is not thread-safe, call it once before sharing the markov chain between threads.
+		@exception std::logic_error Markov chain must be frozen.
+	*/
+	const csc_storage& inverse_index() const {
+		if (!is_frozen) throw std::logic_error("Markov chain must be frozen.");
+		if (has_csc) return csc;
+		auto d = make_surround_log("Building predecessor index of markov chain");
+
+		const std::size_t n_edges{ csr.columns.size() };
+		csc.column_offsets.assign(n_frozen_states + 1, 0);
+		for (const auto& column : csr.columns)
+			++csc.column_offsets[static_cast<std::size_t>(column) + 1];
+		std::partial_sum(csc.column_offsets.cbegin(), csc.column_offsets.cend(), csc.column_offsets.begin());
+		csc.rows.resize(n_edges);
+		csc.positions.resize(n_edges);
+		std::vector<std::size_t> next(csc.column_offsets.cbegin(), csc.column_offsets.cend() - 1);
+		for (std::size_t row{ 0 }; row < n_frozen_states; ++row)
+			for (std::size_t pos{ csr.row_offsets[row] }; pos != csr.row_offsets[row + 1]; ++pos) {
+				const std::size_t k{ next[static_cast<std::size_t>(csr.columns[pos])]++ };
+				csc.rows[k] = static_cast<_IntegralT>(row);
+				csc.positions[k] = pos;
+			}
+		has_csc = true;
+		return csc;
+	}
 
-		const std::size_t pfrom = cfrom - cnv.cbegin();
-		const std::size_t pto = cto - cnv.cbegin();
-		const std::size_t pprob = cprob - cnv.cbegin();
-		std::set<std::size_t> ppositions{ pfrom, pto, pprob };
+	/// @brief Releases the predecessor index built by \a inverse_index().
+	void release_inverse_index() const noexcept {
+		csc = csc_storage();
+		has_csc = false;
+	}
 
-		//check all other lines for being in right format (wellformed body)
-		const auto gmc_s_value_format{ std::string(R"([+-]?([0-9]*[.])?[0-9]+)") };
-		const auto gmc_s_separator{ std::string(R"(\s*,\s*)") };
+	/**
+		@brief Reads a prism transitions file to build up a markov chain.
+		@details The markov chain must be empty before reading file. The stream is read into memory once and then parsed like a mapped file,
+		see \a read_transitions_from_prism_file(const std::string&, bool).
+		@exception std::invalid_argument Bad stream.
+	*/
+	void read_transitions_from_prism_file(std::istream& transitions, bool strict = false) {
+		if (!transitions.good()) throw std::invalid_argument("Bad stream.");
+		std::ostringstream buffer;
+		buffer << transitions.rdbuf();
+		const auto input_s{ buffer.str() };
+		read_transitions_from_prism_range(input_s.data(), input_s.data() + input_s.size(), strict);
+	}
 
-		const auto gmc_s_value_definition_line{ [&]() {
-			auto result{ std::string() };
-			result.reserve(gmc_s_separator.size() * (column_names_vector.size() - 1) + gmc_s_value_format.size() * column_names_vector.size() + 1);
-			for (std::size_t i = 0; i < column_names_vector.size() - 1; ++i) (result += gmc_s_value_format) += gmc_s_separator;
-			return result += gmc_s_value_format;
-		}() };
+	/**
+		@brief Reads a prism transitions file to build up a markov chain.
+		@details The markov chain must be empty before reading file. The file is memory-mapped and parsed in a single pass without regexes.
+		The created markov chain is already frozen (see \a freeze()). Its states are all state ids occurring in some transition, they need not be contiguous.
+		If \a strict is set, the whole file is additionally matched against \a regxc::prism_file_format before parsing.
+		@exception std::invalid_argument Could not open file.
+		@exception std::logic_error Forbidden to read transitions from file if markov chain is not empty.
+		@exception std::invalid_argument The input is maleformed. (only if \a strict)
+		@exception std::logic_error Could not find end of the header line.
+		@exception std::logic_error Could not find number of states in header line.
+		@exception std::logic_error Could not find number of transitions in header line.
+		@exception std::invalid_argument Found a transition line which does not contain exactly 3 numbers.
+		@exception std::invalid_argument Trying to add a transition that already exists.
+	*/
+	void read_transitions_from_prism_file(const std::string& file_path, bool strict = false) {
+		const mapped_file input(file_path);
+		read_transitions_from_prism_range(input.begin(), input.end(), strict);
+	}
 
-		const auto gmc_value_definition_body{ boost::regex(
-			std::string("((") + gmc_s_irgnored_line + "|" + gmc_s_value_definition_line + ")?(" + gmc_s_new_line + "|$))*"
-		) };
+	/**
+		@brief Reads a prism rewards file into the edge decoration at \a index_of_reward.
+		@details The stream is read into memory once and then parsed like a mapped file,
+		see \a read_rewards_from_prism_file(const std::string&, const std::size_t&, bool).
+		@exception std::invalid_argument Bad stream.
+	*/
+	void read_rewards_from_prism_file(std::istream& rewards, const std::size_t& index_of_reward = 0, bool strict = false) {
+		if (!rewards.good()) throw std::invalid_argument("Bad stream.");
+		std::ostringstream buffer;
+		buffer << rewards.rdbuf();
+		const auto input_s{ buffer.str() };
+		read_rewards_from_prism_range(input_s.data(), input_s.data() + input_s.size(), index_of_reward, strict);
+	}
 
-		try {
-		std::cout << "Check for wellformed body: " <<
-			interprete_bool_n(boost::regex_match(semantics_definition_end, test_file_string.cend(), gmc_value_definition_body));
-		}
-		catch (const std::runtime_error & e) {
-			std::cout << "WARNING: Could not check for wellformed body. boost::regex throwed std::runtime_error:\n\t\t" << e.what() << "\n";
-		}
+	/**
+		@brief Reads a prism rewards file into the edge decoration at \a index_of_reward.
+		@details Checks whether the markov chain has all the transitions that rewards are defined for in given file.
+		The file is memory-mapped and parsed in a single pass without regexes.
+		If \a strict is set, the whole file is additionally matched against \a regxc::prism_file_format before parsing.
+		@exception std::invalid_argument Could not open file.
+		@exception std::logic_error Markov chain has not enough space for rewards.
+		@exception std::invalid_argument The file is not well-formed. (only if \a strict)
+		@exception std::invalid_argument Found a reward line which does not contain exactly 3 numbers.
+		@exception std::invalid_argument File defines reward for some non-existent edge.
+	*/
+	void read_rewards_from_prism_file(const std::string& file_path, const std::size_t& index_of_reward = 0, bool strict = false) {
+		const mapped_file input(file_path);
+		read_rewards_from_prism_range(input.begin(), input.end(), index_of_reward, strict);
+	}
 
-		//read all lines of body:
-		if (!empty()) throw std::logic_error("Forbidden to read transitions from file if markov chain is not empty.");
+	/**
+		@brief Reads a general markov chain file and builds up the corresponding markov chain as object.
+		@details The stream is read into memory once and then parsed like a mapped file, see \a read_from_gmc_file(const std::string&, bool).
+		@exception std::invalid_argument Bad stream.
+	*/
+	void read_from_gmc_file(std::istream& input, bool strict = false) {
+		if (!input.good()) throw std::invalid_argument("Bad stream.");
+		std::ostringstream buffer;
+		buffer << input.rdbuf();
+		const auto input_s{ buffer.str() };
+		read_from_gmc_range(input_s.data(), input_s.data() + input_s.size(), strict);
+	}
 
-		for (
-			auto def_line_it{ regex_iterator(semantics_definition_end, test_file_string.cend(), boost::regex(gmc_s_value_definition_line)) };
-			def_line_it != regex_iterator();
-			++def_line_it) {
+	/**
+		@brief Reads a general markov chain file and builds up the corresponding markov chain as object.
+		@details A gmc file starts with optional comment lines (beginning with #) followed by the semantics definition, a comma separated list of column names.
+		Columns $from, $to and $prob are required, any other column $k is stored as edge decoration k.
+		Each following line defines one transition by comma separated values in the order of the columns, blank lines and comment lines are ignored.
+		The file is memory-mapped. The column layout is resolved once, then each line is parsed in a single pass without regexes.
+		The created markov chain is already frozen (see \a freeze()). Its states are all state ids occurring in some transition, they need not be contiguous.
+		If \a strict is set, the file is additionally matched against the regexes describing the gmc format.
+		@exception std::invalid_argument Could not open file.
+		@exception std::logic_error Forbidden to read transitions from file if markov chain is not empty.
+		@exception std::invalid_argument No valid GENERAL MARKOV CHAIN format (only if \a strict)
+		@exception std::invalid_argument Syntax error: did not find exactly one semantics defintion.
+		@exception std::invalid_argument No $from column / No $to column / No $prob column
+		@exception std::invalid_argument Some column is defined twice or does not name a valid edge decoration index.
+		@exception std::invalid_argument Could not read some parameter.
+		@exception std::invalid_argument Trying to add a transition that already exists.
+	*/
+	void read_from_gmc_file(const std::string& file_path, bool strict = false) {
+		const mapped_file input(file_path);
+		read_from_gmc_range(input.begin(), input.end(), strict);
+	}
 
-			// for each line defining some edge
-			std::vector<std::string> row_items;
-			const std::string line{ def_line_it->str() };
-			boost::split(row_items, line, boost::is_any_of(",")); // split the line at the commata
-			if (row_items.size() != cnv.size()) throw std::logic_error("This should be already catched by regex match.");
-			for (auto& item : row_items) item = boost::regex_replace(item, boost::regex("\\s"), "");
-
-			unsigned long from{ 0 }, to{ 0 };
-			_RationalT p{ 0 };
-			try {
-				from = std::stoull(row_items[pfrom]);
-				to = std::stoull(row_items[pto]);
-				p = std::stod(row_items[pprob]);
-
-				//create edge:
-				auto e = new edge(p, n_edge_decorations);
-
-				// check if edge alr4eady exists!!!
-				forward_transitions[from][to] = e;
-				inverse_transitions[to][from] = e;
-				init_state(from);
-				init_state(to);
-					
-				//set rewards
-				for (std::size_t i = 0; i < cnv.size(); ++i) {
-					if (ppositions.find(i) != ppositions.cend()) continue;
-					std::size_t reward_index{ std::stoull(cnv[i].substr(1)) };
-					double reward{ std::stod(row_items[i]) };
-					e->decorations.at(reward_index) = reward;
-				}
-			}
-			catch (...) {
-				throw std::invalid_argument("Could not read some parameter");
-			}
-		}
+	/**
+		@brief Writes the markov chain to a binary snapshot, see \a binary_format.
+		@details The markov chain is frozen first (see \a freeze()). The snapshot contains the CSR arrays, all edge and node decorations, the state ids and a checksum.
+		@exception std::invalid_argument Bad stream.
+		@exception std::runtime_error Could not write binary snapshot.
+	*/
+	void write_binary(std::ostream& output) {
+		if (!output.good()) throw std::invalid_argument("Bad stream.");
+		freeze();
+		auto d = make_surround_log("Writing binary snapshot of markov chain");
+
+		binary_format::header header{};
+		std::memcpy(header.magic, binary_format::magic, sizeof(header.magic));
+		header.version = binary_format::version;
+		header.byte_order_mark = binary_format::byte_order_mark;
+		header.size_integral = sizeof(_IntegralT);
+		header.size_rational = sizeof(_RationalT);
+		header.n_states = n_frozen_states;
+		header.n_edges = csr.columns.size();
+		header.n_edge_decorations = n_edge_decorations;
+		header.n_node_decorations = n_node_decorations;
+		header.n_state_ids = state_ids.size();
+
+		binary_format::checksum sum;
+		binary_format::write_section(output, sum, &header, sizeof(header));
+		std::vector<std::uint64_t> row_offsets(csr.row_offsets.cbegin(), csr.row_offsets.cend());
+		if (row_offsets.empty()) row_offsets.push_back(0); // empty markov chain, not frozen
+		binary_format::write_section(output, sum, row_offsets.data(), row_offsets.size() * sizeof(std::uint64_t));
+		binary_format::write_section(output, sum, csr.columns.data(), csr.columns.size() * sizeof(_IntegralT));
+		binary_format::write_section(output, sum, csr.probabilities.data(), csr.probabilities.size() * sizeof(_RationalT));
+		for (std::size_t k{ 0 }; k < n_edge_decorations; ++k)
+			binary_format::write_section(output, sum, csr.edge_decorations[k].data(), csr.columns.size() * sizeof(_RationalT));
+		for (std::size_t k{ 0 }; k < n_node_decorations; ++k)
+			binary_format::write_section(output, sum, node_decorations[k].data(), n_frozen_states * sizeof(_RationalT));
+		binary_format::write_section(output, sum, state_ids.data(), state_ids.size() * sizeof(_IntegralT));
+		const std::uint64_t checksum{ sum.value() };
+		output.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+		if (!output.good()) throw std::runtime_error("Could not write binary snapshot.");
+	}
+
+	/**
+		@brief Reads a binary snapshot written by \a write_binary.
+		@details The markov chain must be empty. Its numbers of edge and node decorations are taken from the snapshot.
+		The file is memory-mapped, checked against its checksum and the arrays are copied as a whole, nothing is parsed.
+		Since the checksum only detects accidental corruption, the transitions of all rows are validated in parallel before the markov chain is frozen.
+		@exception std::invalid_argument Could not open file.
+		@exception std::logic_error Forbidden to load a binary snapshot if markov chain is not empty.
+		@exception std::invalid_argument Not a markov chain binary snapshot.
+		@exception std::invalid_argument Unsupported version, different byte order or different number types.
+		@exception std::invalid_argument Binary snapshot is truncated or corrupted.
+		@exception std::invalid_argument Binary snapshot contains transitions to non-existent states, or unsorted or duplicate transitions within a row.
+	*/
+	void read_binary(const std::string& file_path) {
+		auto d = make_surround_log("Loading markov chain from binary snapshot");
+		if (!empty()) throw std::logic_error("Forbidden to load a binary snapshot if markov chain is not empty.");
+		const mapped_file input(file_path);
+
+		binary_format::header header;
+		if (input.size() < sizeof(header)) throw std::invalid_argument("Not a markov chain binary snapshot.");
+		std::memcpy(&header, input.begin(), sizeof(header));
+		if (std::memcmp(header.magic, binary_format::magic, sizeof(header.magic)) != 0) throw std::invalid_argument("Not a markov chain binary snapshot.");
+		if (header.byte_order_mark != binary_format::byte_order_mark) throw std::invalid_argument("Binary snapshot was written on a machine with different byte order.");
+		if (header.version != binary_format::version) throw std::invalid_argument("Unsupported binary snapshot version " + std::to_string(header.version) + ".");
+		if (header.size_integral != sizeof(_IntegralT) || header.size_rational != sizeof(_RationalT))
+			throw std::invalid_argument("Binary snapshot was written with different number types.");
+
+		// locate sections:
+		const auto truncated{ "Binary snapshot is truncated." };
+		std::size_t offset{ sizeof(header) };
+		const auto take_section = [&](const std::uint64_t& count, const std::size_t& element_size) {
+			if (count > input.size()) throw std::invalid_argument(truncated);
+			const std::size_t size{ binary_format::padded(static_cast<std::size_t>(count) * element_size) };
+			if (size > input.size() - offset) throw std::invalid_argument(truncated);
+			const char* section{ input.begin() + offset };
+			offset += size;
+			return section;
+		};
+		const std::size_t n_states{ static_cast<std::size_t>(header.n_states) };
+		const std::size_t n_edges{ static_cast<std::size_t>(header.n_edges) };
+		const char* row_offsets_section{ take_section(header.n_states + 1, sizeof(std::uint64_t)) };
+		const char* columns_section{ take_section(header.n_edges, sizeof(_IntegralT)) };
+		const char* probabilities_section{ take_section(header.n_edges, sizeof(_RationalT)) };
+		std::vector<const char*> edge_decoration_sections;
+		for (std::uint64_t k{ 0 }; k < header.n_edge_decorations; ++k)
+			edge_decoration_sections.push_back(take_section(header.n_edges, sizeof(_RationalT)));
+		std::vector<const char*> node_decoration_sections;
+		for (std::uint64_t k{ 0 }; k < header.n_node_decorations; ++k)
+			node_decoration_sections.push_back(take_section(header.n_states, sizeof(_RationalT)));
+		if (header.n_state_ids != 0 && header.n_state_ids != header.n_states) throw std::invalid_argument("Binary snapshot contains invalid state ids.");
+		const char* state_ids_section{ take_section(header.n_state_ids, sizeof(_IntegralT)) };
+		if (input.size() - offset != sizeof(std::uint64_t)) throw std::invalid_argument(truncated);
+
+		binary_format::checksum sum;
+		sum.add(input.begin(), offset);
+		std::uint64_t checksum{ 0 };
+		std::memcpy(&checksum, input.begin() + offset, sizeof(checksum));
+		if (checksum != sum.value()) throw std::invalid_argument("Checksum mismatch, binary snapshot is corrupted.");
+
+		// copy arrays:
+		std::vector<std::uint64_t> row_offsets(n_states + 1);
+		std::memcpy(row_offsets.data(), row_offsets_section, row_offsets.size() * sizeof(std::uint64_t));
+		if (row_offsets.front() != 0 || row_offsets.back() != n_edges || !std::is_sorted(row_offsets.cbegin(), row_offsets.cend()))
+			throw std::invalid_argument("Binary snapshot contains invalid row offsets.");
+		std::vector<_IntegralT> columns(n_edges);
+		if (n_edges) std::memcpy(columns.data(), columns_section, n_edges * sizeof(_IntegralT));
+		// columns must be states and strictly increasing within each row, rows are split into independent ranges:
+		const std::size_t n_tasks{ parallel_task_count(n_edges) };
+		run_in_parallel(n_tasks, [&](const std::size_t& task) {
+				const std::size_t rows_begin{ n_states * task / n_tasks };
+				const std::size_t rows_end{ n_states * (task + 1) / n_tasks };
+				for (std::size_t row{ rows_begin }; row < rows_end; ++row)
+					for (std::size_t pos{ static_cast<std::size_t>(row_offsets[row]) }; pos < row_offsets[row + 1]; ++pos) {
+						if (!(static_cast<std::size_t>(columns[pos]) < n_states))
+							throw std::invalid_argument("Binary snapshot contains a transition to a non-existent state.");
+						if (pos != row_offsets[row] && !(columns[pos - 1] < columns[pos]))
+							throw std::invalid_argument("Binary snapshot contains unsorted or duplicate transitions.");
+					}
+			});
+		n_edge_decorations = static_cast<std::size_t>(header.n_edge_decorations);
+		n_node_decorations = static_cast<std::size_t>(header.n_node_decorations);
+		if (n_states == 0) return;
+
+		csr.row_offsets.assign(row_offsets.cbegin(), row_offsets.cend());
+		csr.columns = std::move(columns);
+		csr.probabilities.resize(n_edges);
+		std::memcpy(csr.probabilities.data(), probabilities_section, n_edges * sizeof(_RationalT));
+		csr.edge_decorations.assign(n_edge_decorations, std::vector<_RationalT>(n_edges));
+		for (std::size_t k{ 0 }; k < n_edge_decorations; ++k)
+			std::memcpy(csr.edge_decorations[k].data(), edge_decoration_sections[k], n_edges * sizeof(_RationalT));
+		n_frozen_states = n_states;
+		node_decorations.assign(n_node_decorations, std::vector<_RationalT>(n_states));
+		for (std::size_t k{ 0 }; k < n_node_decorations; ++k)
+			std::memcpy(node_decorations[k].data(), node_decoration_sections[k], n_states * sizeof(_RationalT));
+		state_ids.resize(static_cast<std::size_t>(header.n_state_ids));
+		if (!state_ids.empty()) std::memcpy(state_ids.data(), state_ids_section, state_ids.size() * sizeof(_IntegralT));
+		if (!std::is_sorted(state_ids.cbegin(), state_ids.cend()) || std::adjacent_find(state_ids.cbegin(), state_ids.cend()) != state_ids.cend())
+			throw std::invalid_argument("Binary snapshot contains invalid state ids.");
+		is_frozen = true;
 	}
 
 	markov_chain& operator=(const markov_chain&) = delete;
 
 	markov_chain(const markov_chain&) = delete;
 
-	~markov_chain() {
-		for (const auto& i : forward_transitions) {
-			for (const auto& j : i.second) {
-				delete j.second;
-			}
-		}
+	/// @brief Returns counters about the allocations of edges and their decorations in the not yet frozen representation.
+	const arena::statistics& edge_allocation_statistics() const noexcept {
+		return edge_arena.stats();
 	}
 
 	/**
 		@brief Assignes the values of given array structure as state decorations to the states.
-		@details source needs an operator[] takeing an \tparam _Integer for state id.
+		@details source needs an operator[] takeing an \tparam _Integer for the dense state index if the markov chain is frozen, for state id otherwise.
+		If the markov chain is frozen, the values are copied in parallel, so \a source must allow concurrent reading.
 	*/
 	template<class _Array>
 	void set_decoration(const _Array& source, std::size_t index) {
 		if (!(index < n_node_decorations)) throw std::out_of_range("Not enough decorations defined.");
+		if (is_frozen) {
+			auto& column{ node_decorations[index] };
+			for_each_chunk(n_frozen_states, [&](const std::size_t& first, const std::size_t& last) {
+				for (std::size_t i{ first }; i < last; ++i)
+					column[i] = source[i];
+			});
+			return;
+		}
 		for (auto it{ states.begin() }; it != states.end(); ++it)
 			it->second.decorations[index] = source[it->first];
 
@@ -433,6 +1186,14 @@ public:
 		@param output stream to write decorations to.
 	*/
 	void write_edge_decorations(std::ostream& output) {
+		if (is_frozen) {
+			for (std::size_t i{ 0 }; i < n_frozen_states; ++i) {
+				output << state_id(i) << ":";
+				for (const auto& column : node_decorations) output << " " << column[i];
+				output << '\n';
+			}
+			return;
+		}
 		for (const auto& pair : states) {
 			output << pair.first << ":";
 			for (const auto& deco : pair.second.decorations) output << " " << deco;
@@ -448,6 +1209,9 @@ public:
 	friend nlohmann::json generate_herman(markov_chain<_Rationals, _Integers>& mc, const _Integers& size, std::unique_ptr<_Set>& target_set);
 
 	template <class mc_type, class set_type>
-	friend sparse_matrix target_adjusted_probability_matrix(const mc_type& mc, const set_type& target_states);
+	friend state_reduction reduce_states(const mc_type& mc, const set_type& target_states, const std::optional<std::size_t>& initial_state);
+
+	template <class mc_type>
+	friend sparse_matrix reduced_system_matrix(const mc_type& mc, const state_reduction& reduction);
 };
 
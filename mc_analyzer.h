@@ -7,24 +7,230 @@
 #pragma once
 
 #include "sparse_matrix.h"
+#include "bit_set.h"
+#include "dense_lu.h"
+#include "parallel.h"
+#include "string_constants.h"
 
+#include "nlohmann/json.hpp"
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <tuple>
+
+
+/**
+	@brief Result of graph-based preprocessing: the states whose values need to be solved for and the values of all other states.
+	@details Indices are dense state indices of the frozen markov chain. See \a reduce_states().
+*/
+struct state_reduction {
+	/// @brief Marks states in \a reduced_index that are not part of the reduced system.
+	static constexpr std::size_t npos{ std::numeric_limits<std::size_t>::max() };
+
+	/// @brief States of the reduced system in ascending order, i.e. \a kept[i] is the state of row i.
+	std::vector<std::size_t> kept;
+	/// @brief Row of each state in the reduced system, or \a npos if the state is excluded.
+	std::vector<std::size_t> reduced_index;
+	/// @brief Value of each excluded state: 0 for target states, infinity for states that reach the target with probability less than 1, NaN for states unreachable from the initial state.
+	std::vector<double> excluded_values;
+
+	std::size_t n_target;
+	std::size_t n_infinite;
+	std::size_t n_unreachable;
+
+	/// @brief Returns the entries of the kept states of \a full.
+	std::vector<double> restrict(const std::vector<double>& full) const {
+		std::vector<double> result(kept.size());
+		for_each_chunk(kept.size(), [&](const std::size_t& first, const std::size_t& last) {
+			for (std::size_t i{ first }; i < last; ++i) result[i] = full[kept[i]];
+		});
+		return result;
+	}
+
+	/// @brief Returns a vector over all states with entries of \a reduced for kept states and \a excluded_values for all others.
+	std::vector<double> expand(const std::vector<double>& reduced) const {
+		std::vector<double> result(excluded_values);
+		for_each_chunk(kept.size(), [&](const std::size_t& first, const std::size_t& last) {
+			for (std::size_t i{ first }; i < last; ++i) result[kept[i]] = reduced[i];
+		});
+		return result;
+	}
+};
 
 /**
-	@brief Returns a sparse matrix that contains transition probabilities such that matrix[from][to] is the probability of the transition \a from --> \a to, except for states \a from in \target_states, there the value is set to zero (i.e. no entry in sparse matrix).
+	@brief Classifies the states of a frozen markov chain by graph search before solving for accumulated rewards until reaching \a target_states.
+	@details Backward search from \a target_states over the predecessor index (see \a markov_chain::inverse_index) finds all states reaching the target with positive probability.
+	A second backward search from the remaining states, avoiding target states, finds all states reaching the target with probability less than 1. Their expected rewards are infinite.
+	If \a initial_state (dense index) is given, only states reachable from it without passing target states are kept.
+	The reduced system contains exactly the states that are neither target, nor infinite, nor unreachable. All successors of kept states are kept or target states, so the reduced system is exact.
+	It is non-singular since all its states reach the target almost surely.
+	\a target_states are dense state indices. Runs in O(states + transitions).
 */
 template <class mc_type, class set_type>
-inline sparse_matrix target_adjusted_probability_matrix(const mc_type& mc, const set_type& target_states) {
-	static_assert(std::is_same<typename mc_type::integral_type, typename set_type::value_type>::value, "Value type of set must equal integral type of markov chain.");
-	auto m{ sparse_matrix(mc.size_states(), mc.size_states()) };
+inline state_reduction reduce_states(const mc_type& mc, const set_type& target_states, const std::optional<std::size_t>& initial_state) {
+	if (!mc.frozen()) throw std::logic_error("Markov chain must be frozen.");
+	const std::size_t n{ mc.size_states() };
+	const auto& csc{ mc.inverse_index() };
+	std::vector<char> is_target(n, false), reaches_target(n, false), infinite(n, false);
+	std::deque<std::size_t> queue;
 
-	for (auto it = mc.forward_transitions.cbegin(); it != mc.forward_transitions.cend(); ++it) {
-		if (target_states.find(it->first) != target_states.cend()) continue;
-		for (auto jt = it->second.cbegin(); jt != it->second.cend(); ++jt)
-			m(it->first, jt->first) = jt->second->probability; //###assumes that states are enumerated from 0 ... to n-1
+	// backward search from target states:
+	for (std::size_t state{ 0 }; state < n; ++state)
+		if (target_states.count(state)) {
+			is_target[state] = true;
+			reaches_target[state] = true;
+			queue.push_back(state);
+		}
+	while (!queue.empty()) {
+		const std::size_t state{ queue.front() };
+		queue.pop_front();
+		for (std::size_t k{ csc.column_offsets[state] }; k != csc.column_offsets[state + 1]; ++k) {
+			const std::size_t predecessor{ csc.rows[k] };
+			if (reaches_target[predecessor]) continue;
+			reaches_target[predecessor] = true;
+			queue.push_back(predecessor);
+		}
 	}
-	return m;
-} //### could also be matrix class member function.
 
+	// backward search from states never reaching the target, not passing target states:
+	for (std::size_t state{ 0 }; state < n; ++state)
+		if (!reaches_target[state]) {
+			infinite[state] = true;
+			queue.push_back(state);
+		}
+	while (!queue.empty()) {
+		const std::size_t state{ queue.front() };
+		queue.pop_front();
+		for (std::size_t k{ csc.column_offsets[state] }; k != csc.column_offsets[state + 1]; ++k) {
+			const std::size_t predecessor{ csc.rows[k] };
+			if (infinite[predecessor] || is_target[predecessor]) continue;
+			infinite[predecessor] = true;
+			queue.push_back(predecessor);
+		}
+	}
+
+	// forward search from the initial state, not passing target or infinite states:
+	std::vector<char> reachable(n, !initial_state);
+	if (initial_state && *initial_state < n) {
+		reachable[*initial_state] = true;
+		queue.push_back(*initial_state);
+	}
+	while (!queue.empty()) {
+		const std::size_t state{ queue.front() };
+		queue.pop_front();
+		if (is_target[state] || infinite[state]) continue;
+		for (std::size_t pos{ mc.csr.row_offsets[state] }; pos != mc.csr.row_offsets[state + 1]; ++pos) {
+			const std::size_t successor{ mc.csr.columns[pos] };
+			if (reachable[successor]) continue;
+			reachable[successor] = true;
+			queue.push_back(successor);
+		}
+	}
+
+	state_reduction result;
+	result.reduced_index.assign(n, state_reduction::npos);
+	result.excluded_values.assign(n, 0);
+	result.n_target = 0;
+	result.n_infinite = 0;
+	result.n_unreachable = 0;
+	for (std::size_t state{ 0 }; state < n; ++state) {
+		if (is_target[state]) {
+			++result.n_target;
+		}
+		else if (infinite[state]) {
+			++result.n_infinite;
+			result.excluded_values[state] = std::numeric_limits<double>::infinity();
+		}
+		else if (!reachable[state]) {
+			++result.n_unreachable;
+			result.excluded_values[state] = std::numeric_limits<double>::quiet_NaN();
+		}
+		else {
+			result.reduced_index[state] = result.kept.size();
+			result.kept.push_back(state);
+		}
+	}
+	return result;
+}
+
+/**
+	@brief Returns the system matrix P - I for calculating expects, restricted to the rows and columns of the states kept by \a reduction.
+	@details P contains the transition probabilities of the frozen markov chain. Transitions into target states are dropped, since target states have value 0.
+	Rows are built in parallel in two passes over the CSR rows of the kept states: the first one counts the entries of each row, the second one writes them to their final positions.
+*/
+template <class mc_type>
+inline sparse_matrix reduced_system_matrix(const mc_type& mc, const state_reduction& reduction) {
+	if (!mc.frozen()) throw std::logic_error("Markov chain must be frozen.");
+	using index_type = sparse_matrix::index_type;
+	const std::size_t n{ reduction.kept.size() };
+
+	// calls emit(column, value) for each entry of the given row in ascending order of columns:
+	const auto for_each_entry = [&](const std::size_t& row, auto&& emit) {
+		const std::size_t state{ reduction.kept[row] };
+		bool diagonal_done{ false };
+		for (std::size_t pos{ mc.csr.row_offsets[state] }; pos != mc.csr.row_offsets[state + 1]; ++pos) {
+			const std::size_t column{ reduction.reduced_index[mc.csr.columns[pos]] };
+			if (column == state_reduction::npos) continue;
+			if (!diagonal_done && !(column < row)) {
+				diagonal_done = true;
+				if (column == row) {
+					emit(column, mc.csr.probabilities[pos] - 1);
+					continue;
+				}
+				emit(row, -1);
+			}
+			emit(column, mc.csr.probabilities[pos]);
+		}
+		if (!diagonal_done) emit(row, -1);
+	};
+
+	std::vector<index_type> row_offsets(n + 1, 0);
+	for_each_chunk(n, [&](const std::size_t& first, const std::size_t& last) {
+		for (std::size_t row{ first }; row != last; ++row)
+			for_each_entry(row, [&](const std::size_t&, const double&) { ++row_offsets[row + 1]; });
+	});
+	std::partial_sum(row_offsets.cbegin(), row_offsets.cend(), row_offsets.begin());
+
+	std::vector<index_type> columns(static_cast<std::size_t>(row_offsets.back()));
+	std::vector<double> values(columns.size());
+	for_each_chunk(n, [&](const std::size_t& first, const std::size_t& last) {
+		for (std::size_t row{ first }; row != last; ++row) {
+			std::size_t pos{ static_cast<std::size_t>(row_offsets[row]) };
+			for_each_entry(row, [&](const std::size_t& column, const double& value) {
+				columns[pos] = static_cast<index_type>(column);
+				values[pos] = value;
+				++pos;
+			});
+		}
+	});
+	return sparse_matrix(n, n, std::move(row_offsets), std::move(columns), std::move(values));
+}
+
+
+/**
+	@brief Returns the sum of \a a[i] * \a b[i] for i in [0, \a n).
+	@details Accumulates four independent partial sums, so that the compiler can use vector instructions without reordering floating point additions on its own.
+*/
+template<class _T>
+inline _T dot_product(const _T* a, const _T* b, const std::size_t& n) noexcept {
+	_T sum_0{ 0 }, sum_1{ 0 }, sum_2{ 0 }, sum_3{ 0 };
+	std::size_t i{ 0 };
+	for (; i + 4 <= n; i += 4) {
+		sum_0 += a[i] * b[i];
+		sum_1 += a[i + 1] * b[i + 1];
+		sum_2 += a[i + 2] * b[i + 2];
+		sum_3 += a[i + 3] * b[i + 3];
+	}
+	for (; i < n; ++i) sum_0 += a[i] * b[i];
+	return (sum_0 + sum_1) + (sum_2 + sum_3);
+}
 
 /**
 	@brief Contains static functions for analyzing and calculating values from markov chains.
@@ -33,103 +239,948 @@ template<class _RationalT, class _IntegerT>
 struct mc_analyzer {
 
 	using mc_type = markov_chain<_RationalT, _IntegerT>;
-	using set_type = std::unordered_set<_IntegerT>;
+	using set_type = bit_set<_IntegerT>;
+
+	/**
+		@brief Calls \a task(first, last) for consecutive chunks [first, last) of all states, in parallel.
+		@details Chunks have about the same number of transitions. The markov chain must be frozen.
+	*/
+	template<class _Task>
+	static void for_each_state_chunk(const mc_type& mc, _Task&& task) {
+		const auto& row_offsets{ mc.csr.row_offsets };
+		const auto chunks{ split_rows(mc.size_states(), parallel_task_count(row_offsets.back()), [&](const std::size_t& state) { return row_offsets[state]; }) };
+		run_in_parallel(chunks.size() - 1, [&](const std::size_t& c) { task(chunks[c], chunks[c + 1]); });
+	}
 
 	/**
 		@brief Calculates image vector in linear system of equations for calculation of expects.
+		@details The markov chain must be frozen. Entries of states in \a target_states (dense state indices) are zero.
+		Each entry is a dot product of the probabilities and the rewards of the state's transitions, which lie next to each other in the CSR arrays.
+		States are split into chunks of about the same number of transitions, which are processed in parallel.
 	*/
-	static std::vector<_RationalT> rewarded_image_vector(const sparse_matrix& target_adjusted_matrix, const mc_type& mc, const std::size_t& reward_selector) {
+	template<class _Set>
+	static std::vector<_RationalT> rewarded_image_vector(const mc_type& mc, const _Set& target_states, const std::size_t& reward_selector) {
 		if (!(reward_selector < mc.n_edge_decorations)) throw std::invalid_argument("Given markov chain has to few rewards.");
-		auto result{ std::vector<_RationalT>(target_adjusted_matrix.size_m(), 0) };
-		for (sparse_matrix::size_t state_s{ 0 }; state_s != target_adjusted_matrix.size_m(); ++state_s) {
-			result[state_s] = -std::accumulate(target_adjusted_matrix[state_s].cbegin(), target_adjusted_matrix[state_s].cend(), _RationalT(0.0),
-				[&](const _RationalT& val, const auto& appendee /*pointing to state "t"*/) {
-					try {
-						return val + appendee.second /*P_{-> A} */ * mc.forward_transitions.at(state_s).at(appendee.first)->decorations[reward_selector];
-					}
-					catch (const std::out_of_range&) {
-						return val;
-					}
-				});
-		}
+		if (!mc.frozen()) throw std::logic_error("Markov chain must be frozen.");
+		const auto& row_offsets{ mc.csr.row_offsets };
+		const _RationalT* const probabilities{ mc.csr.probabilities.data() };
+		const _RationalT* const rewards{ mc.csr.edge_decorations[reward_selector].data() };
+		auto result{ std::vector<_RationalT>(mc.size_states(), 0) };
+		for_each_state_chunk(mc, [&](const std::size_t& first, const std::size_t& last) {
+			for (std::size_t state_s{ first }; state_s != last; ++state_s) {
+				if (target_states.count(state_s)) continue;
+				const std::size_t begin{ row_offsets[state_s] };
+				result[state_s] = -dot_product(probabilities + begin /*P_{-> A} */, rewards + begin, row_offsets[state_s + 1] - begin);
+			}
+			});
 		return result;
 	}
 
-	/** 
-		Stores a new composed reward function for variance as edge decorations in the markoch chain mc.
+	/**
+		@brief Calculates image vectors for several rewards at once, see \a rewarded_image_vector.
+		@details The CSR structure and the probabilities of each state are read once for all rewards. Element \a i of the result belongs to \a reward_selectors[i].
 	*/
-	static void calculate_variance_reward(mc_type& mc, std::size_t index_basic_reward, std::size_t index_basic_decoration, std::size_t index_destination_reward){
-		if (!(index_basic_reward < mc.n_edge_decorations)) throw std::out_of_range("Basic reward out of range.");
-		if (!(index_destination_reward < mc.n_edge_decorations)) throw std::out_of_range("Destination reward out of range.");
-		if (!(index_basic_decoration < mc.n_node_decorations)) throw std::out_of_range("Basic decoration out of range.");
-		for (auto it{ mc.forward_transitions.begin() }; it != mc.forward_transitions.end(); ++it) {
-			for (auto jt{ it->second.begin() }; jt != it->second.end(); ++jt) {
-				double factor{ mc.states.at(jt->first).decorations[index_basic_decoration]
-					+ jt->second->decorations[index_basic_reward]
-					- mc.states.at(it->first).decorations[index_basic_decoration]
-				};
-				jt->second->decorations[index_destination_reward] = factor * factor;
+	template<class _Set>
+	static std::vector<std::vector<_RationalT>> rewarded_image_vectors(const mc_type& mc, const _Set& target_states, const std::vector<std::size_t>& reward_selectors) {
+		for (const auto& reward_selector : reward_selectors)
+			if (!(reward_selector < mc.n_edge_decorations)) throw std::invalid_argument("Given markov chain has to few rewards.");
+		if (!mc.frozen()) throw std::logic_error("Markov chain must be frozen.");
+		const std::size_t k{ reward_selectors.size() };
+		auto result{ std::vector<std::vector<_RationalT>>(k, std::vector<_RationalT>(mc.size_states(), 0)) };
+		const auto& row_offsets{ mc.csr.row_offsets };
+		const _RationalT* const probabilities{ mc.csr.probabilities.data() };
+		std::vector<const _RationalT*> rewards;
+		for (const auto& reward_selector : reward_selectors) rewards.push_back(mc.csr.edge_decorations[reward_selector].data());
+		for_each_state_chunk(mc, [&](const std::size_t& first, const std::size_t& last) {
+			for (std::size_t state_s{ first }; state_s != last; ++state_s) {
+				if (target_states.count(state_s)) continue;
+				const std::size_t begin{ row_offsets[state_s] };
+				const std::size_t length{ row_offsets[state_s + 1] - begin };
+				for (std::size_t i{ 0 }; i != k; ++i) result[i][state_s] = -dot_product(probabilities + begin, rewards[i] + begin, length);
 			}
-		}
+			});
+		return result;
 	}
 
 	/**
-		Stores a new composed reward function for covariance as edge decorations in the markoch chain mc.
+		@brief Calculates the image vector of the linear system for variances from the expects of the same reward, in one pass over all transitions.
+		@details The entry of state s is -sum_t P(s,t) * (expects[t] + reward(s,t) - expects[s])^2, or zero for states in \a target_states (dense state indices).
+		The squared terms are only computed on the fly and never stored.
+		The markov chain must be frozen. \a expects are given per dense state index, as returned by the solver.
 	*/
-	static void calculate_covariance_reward(mc_type& mc, std::size_t index_basic_reward_1, std::size_t index_basic_reward_2, std::size_t index_basic_decoration_1, std::size_t index_basic_decoration_2, std::size_t index_destination_reward) {
-		if (!(index_basic_reward_1 < mc.n_edge_decorations)) throw std::out_of_range("Basic reward out of range.");
-		if (!(index_basic_reward_2 < mc.n_edge_decorations)) throw std::out_of_range("Basic reward out of range.");
-		if (!(index_destination_reward < mc.n_edge_decorations)) throw std::out_of_range("Destination reward out of range.");
-		if (!(index_basic_decoration_1 < mc.n_node_decorations)) throw std::out_of_range("Basic decoration out of range.");
-		if (!(index_basic_decoration_2 < mc.n_node_decorations)) throw std::out_of_range("Basic decoration out of range.");
-		for (auto it{ mc.forward_transitions.begin() }; it != mc.forward_transitions.end(); ++it) {
-			for (auto jt{ it->second.begin() }; jt != it->second.end(); ++jt) {
-				double factor1{
-					mc.states.at(jt->first).decorations[index_basic_decoration_1]
-					+ jt->second->decorations[index_basic_reward_1]
-					- mc.states.at(it->first).decorations[index_basic_decoration_1]
-				};
-				double factor2{
-					mc.states.at(jt->first).decorations[index_basic_decoration_2]
-					+ jt->second->decorations[index_basic_reward_2]
-					- mc.states.at(it->first).decorations[index_basic_decoration_2]
-				};
-				jt->second->decorations[index_destination_reward] = factor1 * factor2;
+	template<class _Set>
+	static std::vector<_RationalT> variance_image_vector(const mc_type& mc, const _Set& target_states, const std::size_t& reward_selector, const std::vector<_RationalT>& expects) {
+		if (!(reward_selector < mc.n_edge_decorations)) throw std::invalid_argument("Given markov chain has to few rewards.");
+		if (!mc.frozen()) throw std::logic_error("Markov chain must be frozen.");
+		if (expects.size() != mc.size_states()) throw std::invalid_argument("Expects do not match the markov chain.");
+		const auto& rewards{ mc.csr.edge_decorations[reward_selector] };
+		auto result{ std::vector<_RationalT>(mc.size_states(), 0) };
+		for_each_state_chunk(mc, [&](const std::size_t& first, const std::size_t& last) {
+			for (std::size_t state_s{ first }; state_s != last; ++state_s) {
+				if (target_states.count(state_s)) continue;
+				const _RationalT expect_s{ expects[state_s] };
+				_RationalT sum{ 0 };
+				for (std::size_t pos{ mc.csr.row_offsets[state_s] }; pos != mc.csr.row_offsets[state_s + 1]; ++pos) {
+					const _RationalT deviation{ expects[mc.csr.columns[pos]] + rewards[pos] - expect_s };
+					sum += mc.csr.probabilities[pos] * deviation * deviation;
+				}
+				result[state_s] = -sum;
 			}
-		}
+			});
+		return result;
+	}
+
+	/**
+		@brief Calculates the image vector of the linear system for covariances from the expects of both rewards, in one pass over all transitions.
+		@details The entry of state s is -sum_t P(s,t) * (expects_1[t] + reward_1(s,t) - expects_1[s]) * (expects_2[t] + reward_2(s,t) - expects_2[s]),
+		or zero for states in \a target_states (dense state indices), see \a variance_image_vector.
+	*/
+	template<class _Set>
+	static std::vector<_RationalT> covariance_image_vector(
+		const mc_type& mc,
+		const _Set& target_states,
+		const std::size_t& reward_selector_1,
+		const std::size_t& reward_selector_2,
+		const std::vector<_RationalT>& expects_1,
+		const std::vector<_RationalT>& expects_2) {
+		if (!(reward_selector_1 < mc.n_edge_decorations) || !(reward_selector_2 < mc.n_edge_decorations)) throw std::invalid_argument("Given markov chain has to few rewards.");
+		if (!mc.frozen()) throw std::logic_error("Markov chain must be frozen.");
+		if (expects_1.size() != mc.size_states() || expects_2.size() != mc.size_states()) throw std::invalid_argument("Expects do not match the markov chain.");
+		const auto& rewards_1{ mc.csr.edge_decorations[reward_selector_1] };
+		const auto& rewards_2{ mc.csr.edge_decorations[reward_selector_2] };
+		auto result{ std::vector<_RationalT>(mc.size_states(), 0) };
+		for_each_state_chunk(mc, [&](const std::size_t& first, const std::size_t& last) {
+			for (std::size_t state_s{ first }; state_s != last; ++state_s) {
+				if (target_states.count(state_s)) continue;
+				const _RationalT expect_s_1{ expects_1[state_s] };
+				const _RationalT expect_s_2{ expects_2[state_s] };
+				_RationalT sum{ 0 };
+				for (std::size_t pos{ mc.csr.row_offsets[state_s] }; pos != mc.csr.row_offsets[state_s + 1]; ++pos) {
+					const std::size_t to{ mc.csr.columns[pos] };
+					const _RationalT deviation_1{ expects_1[to] + rewards_1[pos] - expect_s_1 };
+					const _RationalT deviation_2{ expects_2[to] + rewards_2[pos] - expect_s_2 };
+					sum += mc.csr.probabilities[pos] * deviation_1 * deviation_2;
+				}
+				result[state_s] = -sum;
+			}
+			});
+		return result;
 	}
 };
 
 
 /**
-	@brief Solves linear system M * x = b
+	@brief Parameters for AMGCL's runtime interface, selecting Krylov solver, coarsening and relaxation.
+	@details Keys are those of AMGCL's runtime interface, e.g.
+	- \a solver.type: \a cg, \a bicgstab, \a bicgstabl, \a gmres, \a lgmres, \a fgmres, \a idrs, \a richardson
+	- \a solver.tol, \a solver.abstol, \a solver.maxiter, \a solver.M (gmres restart), \a solver.s (idrs)
+	- \a precond.coarsening.type: \a aggregation, \a smoothed_aggregation, \a smoothed_aggr_emin, \a ruge_stuben
+	- \a precond.relax.type: \a spai0, \a spai1, \a ilu0, \a iluk, \a ilut, \a gauss_seidel, \a damped_jacobi, \a chebyshev
+	Additionally, key \a engine selects the solver engine, see \a make_solver_engine.
+*/
+using solver_parameters = boost::property_tree::ptree;
+
+/**
+	@brief Returns the default solver parameters: engine \a auto, and for AMG aggregation coarsening, spai0 relaxation and cg.
+	@details Note that cg assumes a symmetric matrix. Since P - I is not symmetric, bicgstab, gmres or idrs may converge much faster.
+*/
+inline solver_parameters default_solver_parameters() {
+	solver_parameters prm;
+	prm.put("solver.type", "cg");
+	prm.put("precond.coarsening.type", "aggregation");
+	prm.put("precond.relax.type", "spai0");
+	return prm;
+}
+
+/// @brief Converts solver parameters into a flat json object with keys like "solver.type".
+inline nlohmann::json solver_parameters_to_json(const solver_parameters& prm, const std::string& prefix = "") {
+	nlohmann::json result = nlohmann::json::object();
+	for (const auto& child : prm) {
+		const auto key{ prefix.empty() ? child.first : prefix + "." + child.first };
+		if (child.second.empty()) result[key] = child.second.data();
+		else result.update(solver_parameters_to_json(child.second, key));
+	}
+	return result;
+}
+
+/**
+	@brief Interface of engines solving linear systems M * x = b with fixed matrix M for any number of right-hand sides b.
+	@details Engines are set up once for M, see \a make_solver_engine.
 */
-std::vector<double> solve_linear_system(const sparse_matrix& M, const std::vector<double>& b /*, amgcl::profiler<>* optional_profiler = nullptr*/ ) {
+class solver_engine {
+	mutable std::size_t n_solves{ 0 };
+	mutable std::size_t n_iterations{ 0 };
+	mutable double max_residual{ 0 };
+
+protected:
+	/// @brief Adds a finished solve to the figures returned by \a solve_statistics().
+	void record_solve(const std::size_t& iterations, const double& residual) const noexcept {
+		++n_solves;
+		n_iterations += iterations;
+		max_residual = std::max(max_residual, residual);
+	}
+
+public:
+	virtual ~solver_engine() = default;
+
+	/// @brief Solves M * x = b and returns x.
+	virtual std::vector<double> operator()(const std::vector<double>& b) const = 0;
+
+	/**
+		@brief Solves M * x_i = b_i for all given right-hand sides b_i and returns all x_i in the same order.
+		@details The right-hand sides are solved one after another. They only share the set-up of the engine.
+	*/
+	std::vector<std::vector<double>> operator()(const std::vector<std::vector<double>>& bs) const {
+		std::vector<std::vector<double>> xs;
+		xs.reserve(bs.size());
+		for (const auto& b : bs) xs.push_back((*this)(b));
+		return xs;
+	}
 
-	//## read the docs of AMGCL to get to know what a profiler actualy does.
+	/// @brief Returns engine specific figures of the set-up for the performance log.
+	virtual nlohmann::json statistics() const { return nlohmann::json::object(); }
 
-	//amgcl::profiler<> profiler;
-	//auto t_total = profiler.scoped_tic("total");
+	/**
+		@brief Returns the figures of all solves since the last \a reset_solve_statistics() for the performance log: total number of iterations and maximum residual.
+		@details The residual is the one the engine checks, e.g. the relative residual norm for AMG. The result is empty if the engine did not record any solve.
+	*/
+	nlohmann::json solve_statistics() const {
+		if (!n_solves) return nlohmann::json::object();
+		return { { sc::iterations, n_iterations }, { sc::residual, max_residual } };
+	}
+
+	/// @brief Clears the figures returned by \a solve_statistics().
+	void reset_solve_statistics() const noexcept {
+		n_solves = 0;
+		n_iterations = 0;
+		max_residual = 0;
+	}
+};
+
+/**
+	@brief Returns the parameters of \a prm that are meant for AMGCL, i.e. the subtrees \a solver and \a precond.
+	@details All other keys, like \a engine, select and configure the engine, see \a make_solver_engine.
+*/
+inline solver_parameters amgcl_parameters(const solver_parameters& prm) {
+	solver_parameters result;
+	for (const auto& key : { "solver", "precond" }) {
+		const auto child{ prm.get_child_optional(key) };
+		if (child) result.put_child(key, *child);
+	}
+	return result;
+}
 
-	// Create an AMGCL solver for the problem.
-	typedef amgcl::backend::builtin<double> Backend;
-	amgcl::make_solver<
+/**
+	@brief Solver for linear systems M * x = b with fixed matrix M.
+	@details The AMG hierarchy is set up once on construction and reused for every right-hand side b.
+	Krylov solver, coarsening and relaxation are chosen at runtime, see \a solver_parameters.
+	The solver takes ownership of the matrix. AMGCL uses its CSR arrays directly without copying them.
+	@tparam _ValueT scalar type of the matrix, the AMG hierarchy and the Krylov iterations. Right-hand sides and results are converted from and to double.
+	With float, memory and memory traffic of the values are halved, but the residual cannot get much below 1e-6, so \a solver.tol must be chosen accordingly.
+*/
+template<class _ValueT = double>
+class linear_system_solver : public solver_engine {
+public:
+	using backend_type = amgcl::backend::builtin<_ValueT>;
+	using solver_type = amgcl::make_solver<
 		amgcl::amg<
-		Backend,
-		amgcl::coarsening::aggregation,
-		amgcl::relaxation::spai0
+		backend_type,
+		amgcl::runtime::coarsening::wrapper,
+		amgcl::runtime::relaxation::wrapper
 		>,
-		amgcl::solver::cg<Backend>
-	> solve(M);
-	///####check different coarsening and relaxations.
+		amgcl::runtime::solver::wrapper<backend_type>
+	>;
+
+private:
+	basic_sparse_matrix<_ValueT> matrix;
+	solver_parameters prm;
+	solver_type solve;
+
+public:
+	/// @brief Sets up the solver (AMG hierarchy) for matrix \a M.
+	linear_system_solver(basic_sparse_matrix<_ValueT> M, const solver_parameters& prm) : matrix(std::move(M)), prm(prm), solve(matrix.amgcl_matrix(), typename solver_type::params(amgcl_parameters(prm))) {
+		std::cout << solve.precond() << std::endl;
+	}
+
+	linear_system_solver(const linear_system_solver&) = delete;
+	linear_system_solver& operator=(const linear_system_solver&) = delete;
+
+	/// @brief Returns the number of unknowns.
+	std::size_t size() const { return solve.size(); }
+
+	/// @brief Returns the parameters the solver was set up with.
+	const solver_parameters& parameters() const { return prm; }
+
+	/// @brief Solves M * x = b in _ValueT, starting from the given \a x, without converting any vector. Returns the number of iterations and the residual reported by AMGCL.
+	std::tuple<std::size_t, double> solve_in_place(const std::vector<_ValueT>& b, std::vector<_ValueT>& x) const {
+		std::size_t iterations{ 0 };
+		double error{ 0 };
+		std::tie(iterations, error) = solve(b, x);
+		return { iterations, error };
+	}
+
+	/// @brief Solves M * x = b and returns x.
+	std::vector<double> operator()(const std::vector<double>& b) const override {
+		std::vector<_ValueT> x(size(), 0);
+		std::size_t iterations{ 0 };
+		double error{ 0 };
+		if constexpr (std::is_same<_ValueT, double>::value) std::tie(iterations, error) = solve_in_place(b, x);
+		else std::tie(iterations, error) = solve_in_place(std::vector<_ValueT>(b.cbegin(), b.cend()), x);
+		std::cout << "Solved linear system:  iterations: " << iterations << "  error: " << error << std::endl;
+		record_solve(iterations, error);
+		if constexpr (std::is_same<_ValueT, double>::value) return x;
+		else return std::vector<double>(x.cbegin(), x.cend());
+	}
+
+	using solver_engine::operator();
+};
+
+/**
+	@brief Solves M * x = b by mixed-precision iterative refinement: AMG hierarchy and Krylov iterations in float, residuals and solution in double.
+	@details Each step solves M * d = r for the current residual r = b - M * x in single precision (see \a linear_system_solver) and adds the correction d to x.
+	Since each step reduces the residual by about the tolerance \a solver.tol of the inner solves (default 1e-4), a few steps reach a relative residual ||b - M * x|| / ||b|| below \a tolerance,
+	which is checked in double precision. Refinement also stops if a step does not reduce the residual any more.
+	Besides the float AMG hierarchy, which takes about half the memory of a double one, M is kept in double for calculating the residuals.
+*/
+class refinement_solver : public solver_engine {
+public:
+	/// @brief Default tolerance of the relative residual.
+	static constexpr double default_tolerance{ 1e-8 };
+	/// @brief Default tolerance of the inner single precision solves.
+	static constexpr double default_inner_tolerance{ 1e-4 };
+	/// @brief Default maximum number of refinement steps.
+	static constexpr std::size_t default_max_steps{ 100 };
 
-	std::cout << solve.precond() << std::endl;
+private:
+	sparse_matrix matrix;
+	std::unique_ptr<linear_system_solver<float>> inner;
+	double tolerance;
+	std::size_t max_steps;
+	/// @brief Chunk c consists of rows chunk_offsets[c] ... chunk_offsets[c+1]-1, residuals are calculated by one thread per chunk.
+	std::vector<std::size_t> chunk_offsets;
 
-	//auto t_solve = profiler.scoped_tic("solve");
-	std::vector<double>  x(M.size_n(), 0.0);
-	solve(b, x);
+	/// @brief Calculates \a r = \a b - M * \a x and returns ||r||^2.
+	double calculate_residual(const std::vector<double>& b, const std::vector<double>& x, std::vector<double>& r) const {
+		using index_type = sparse_matrix::index_type;
+		std::vector<double> squares(chunk_offsets.size() - 1, 0.0);
+		run_in_parallel(chunk_offsets.size() - 1, [&](const std::size_t& c) {
+			double sum{ 0 };
+			for (std::size_t i{ chunk_offsets[c] }; i < chunk_offsets[c + 1]; ++i) {
+				double r_i{ b[i] };
+				for (auto pos{ matrix.row_begin(static_cast<index_type>(i)) }; pos != matrix.row_end(static_cast<index_type>(i)); ++pos)
+					r_i -= matrix.value(pos) * x[static_cast<std::size_t>(matrix.column(pos))];
+				r[i] = r_i;
+				sum += r_i * r_i;
+			}
+			squares[c] = sum;
+		});
+		return std::accumulate(squares.cbegin(), squares.cend(), 0.0);
+	}
+
+public:
+	/// @brief Sets up the single precision AMG solver for \a M, configured by \a prm.
+	refinement_solver(sparse_matrix M, const solver_parameters& prm, const double& tolerance = default_tolerance, const std::size_t& max_steps = default_max_steps) :
+		matrix(std::move(M)), inner(), tolerance(tolerance), max_steps(max_steps), chunk_offsets()
+	{
+		solver_parameters inner_prm{ prm };
+		if (!inner_prm.get_optional<double>("solver.tol")) inner_prm.put("solver.tol", default_inner_tolerance);
+		inner = std::make_unique<linear_system_solver<float>>(matrix.converted<float>(), inner_prm);
+		chunk_offsets = split_rows(static_cast<std::size_t>(matrix.size_m()), parallel_task_count(matrix.nonzeros()),
+			[&](const std::size_t& i) { return matrix.row_begin(static_cast<sparse_matrix::index_type>(i)); });
+	}
 
-	//if (optional_profiler) *optional_profiler = profiler;
-	return x;
+	using solver_engine::operator();
+
+	/**
+		@brief Solves M * x = b by refinement steps and returns x.
+		@details A step whose correction does not reduce the residual, e.g. because the inner solve diverged, is discarded and refinement stops, so that the best iterate is returned.
+	*/
+	std::vector<double> operator()(const std::vector<double>& b) const override {
+		const std::size_t n{ b.size() };
+		std::vector<double> x(n, 0.0), x_next(n);
+		std::vector<double> r(b), r_next(n);
+		std::vector<float> r_single(n), d(n);
+		const double norm_b{ std::sqrt(std::inner_product(b.cbegin(), b.cend(), b.cbegin(), 0.0)) };
+		double error{ norm_b == 0 ? 0.0 : 1.0 };
+		std::size_t steps{ 0 };
+		std::size_t iterations{ 0 };
+		while (error > tolerance && steps < max_steps) {
+			std::copy(r.cbegin(), r.cend(), r_single.begin());
+			std::fill(d.begin(), d.end(), 0.0f);
+			iterations += std::get<0>(inner->solve_in_place(r_single, d));
+			for (std::size_t i{ 0 }; i < n; ++i) x_next[i] = x[i] + d[i];
+			const double next_error{ std::sqrt(calculate_residual(b, x_next, r_next)) / norm_b };
+			++steps;
+			// also true if next_error is NaN:
+			if (!(next_error < error)) break;
+			x.swap(x_next);
+			r.swap(r_next);
+			error = next_error;
+		}
+		std::cout << "Refined linear system:  steps: " << steps << "  iterations: " << iterations << "  residual: " << error << std::endl;
+		if (!(error <= tolerance)) std::cout << "WARNING:   Refinement stopped without convergence after " << steps << " steps." << std::endl;
+		record_solve(iterations, error);
+		return x;
+	}
+};
+
+/**
+	@brief Sets up an AMG solver for \a M with the scalar type selected by key \a precision of \a prm.
+	@details Precisions:
+	- \a double (default): \a linear_system_solver in double.
+	- \a single: \a linear_system_solver in float. The values of \a M are converted and released before the AMG hierarchy is set up.
+	- \a mixed: \a refinement_solver, with keys \a refinement.tol (default 1e-8) for the relative residual and \a refinement.maxiter (default 100) for the number of steps.
+	@exception std::invalid_argument Unknown precision.
+*/
+inline std::unique_ptr<solver_engine> make_amg_solver(sparse_matrix M, const solver_parameters& prm) {
+	const auto precision{ prm.get<std::string>("precision", "double") };
+	if (precision == "double") return std::make_unique<linear_system_solver<double>>(std::move(M), prm);
+	if (precision == "single") {
+		auto single{ M.converted<float>() };
+		M = sparse_matrix(0, 0);
+		return std::make_unique<linear_system_solver<float>>(std::move(single), prm);
+	}
+	if (precision == "mixed")
+		return std::make_unique<refinement_solver>(std::move(M), prm,
+			prm.get<double>("refinement.tol", refinement_solver::default_tolerance),
+			prm.get<std::size_t>("refinement.maxiter", refinement_solver::default_max_steps));
+	throw std::invalid_argument("Unknown precision: " + precision);
 }
 
+/**
+	@brief Solves M * x = b by decomposing the graph of M into strongly connected components (SCCs), which are solved one after another in reverse topological order.
+	@details The SCCs are found once on construction by an iterative version of Tarjan's algorithm, so that the depth of the graph is not limited by the call stack.
+	Each component only depends on components solved before it:
+	- trivial components (a single state) are solved by back-substitution,
+	- components of up to \a dense_max states by a dense LU decomposition (see \a dense_lu), factorized once,
+	- bigger components by AMG (see \a make_amg_solver) on their sub-matrix, set up once.
+	For mostly acyclic markov chains nearly all states are solved by back-substitution in a single pass over the matrix.
+	M must have non-zero diagonal entries, like the system matrices built from \a reduce_states.
+*/
+class scc_block_solver : public solver_engine {
+public:
+	/// @brief Default maximum size of components solved by dense LU decomposition.
+	static constexpr std::size_t default_dense_max{ 256 };
+
+private:
+	sparse_matrix matrix;
+	/// @brief States grouped by component, components in reverse topological order: component c consists of \a order[component_offsets[c]] ... \a order[component_offsets[c+1]-1].
+	std::vector<std::size_t> order;
+	std::vector<std::size_t> component_offsets;
+	/// @brief Component of each state.
+	std::vector<std::size_t> component_of;
+	/// @brief LU decompositions of components solved densely, nullptr for all other components.
+	std::vector<std::unique_ptr<dense_lu>> dense_solvers;
+	/// @brief AMG solvers of big components, nullptr for all other components.
+	std::vector<std::unique_ptr<solver_engine>> amg_solvers;
+	std::size_t n_trivial;
+	std::size_t n_dense;
+	std::size_t n_amg;
+	std::size_t size_largest;
+
+	/// @brief Finds all SCCs of the graph of \a matrix (ignoring diagonal entries) and stores them in reverse topological order.
+	void find_components() {
+		using index_type = sparse_matrix::index_type;
+		const std::size_t n{ static_cast<std::size_t>(matrix.size_m()) };
+		constexpr std::size_t unvisited{ std::numeric_limits<std::size_t>::max() };
+		std::vector<std::size_t> index(n, unvisited);
+		std::vector<std::size_t> low(n, 0);
+		std::vector<char> on_stack(n, false);
+		std::vector<std::size_t> stack;
+		// explicit call stack of the depth-first search: state and position of the next outgoing entry to visit
+		std::vector<std::pair<std::size_t, index_type>> frames;
+		std::size_t counter{ 0 };
+		component_of.assign(n, 0);
+		order.reserve(n);
+		component_offsets.assign(1, 0);
+
+		const auto visit{ [&](const std::size_t& state) {
+			index[state] = low[state] = counter++;
+			stack.push_back(state);
+			on_stack[state] = true;
+			frames.emplace_back(state, matrix.row_begin(static_cast<index_type>(state)));
+		} };
+		for (std::size_t root{ 0 }; root < n; ++root) {
+			if (index[root] != unvisited) continue;
+			visit(root);
+			while (!frames.empty()) {
+				const std::size_t state{ frames.back().first };
+				index_type& pos{ frames.back().second };
+				if (pos != matrix.row_end(static_cast<index_type>(state))) {
+					const std::size_t successor{ static_cast<std::size_t>(matrix.column(pos++)) };
+					if (successor == state) continue;
+					if (index[successor] == unvisited) visit(successor);
+					else if (on_stack[successor]) low[state] = std::min(low[state], index[successor]);
+					continue;
+				}
+				if (low[state] == index[state]) { // state is root of a component, all of its states are on top of the stack
+					const std::size_t component{ component_offsets.size() - 1 };
+					std::size_t member;
+					do {
+						member = stack.back();
+						stack.pop_back();
+						on_stack[member] = false;
+						component_of[member] = component;
+						order.push_back(member);
+					} while (member != state);
+					component_offsets.push_back(order.size());
+				}
+				frames.pop_back();
+				if (!frames.empty()) low[frames.back().first] = std::min(low[frames.back().first], low[state]);
+			}
+		}
+	}
+
+public:
+	/// @brief Finds the components of \a M and sets up the solvers of all non-trivial components. \a prm configures the AMG solvers of components bigger than \a dense_max, see \a make_amg_solver.
+	scc_block_solver(sparse_matrix M, const solver_parameters& prm, const std::size_t& dense_max = default_dense_max) :
+		matrix(std::move(M)), order(), component_offsets(), component_of(), dense_solvers(), amg_solvers(), n_trivial(0), n_dense(0), n_amg(0), size_largest(0)
+	{
+		using index_type = sparse_matrix::index_type;
+		find_components();
+		const std::size_t n_components{ component_offsets.size() - 1 };
+		dense_solvers.resize(n_components);
+		amg_solvers.resize(n_components);
+		std::vector<std::size_t> local_index(order.size(), 0);
+		std::vector<std::pair<index_type, double>> row;
+		for (std::size_t c{ 0 }; c < n_components; ++c) {
+			const std::size_t first{ component_offsets[c] };
+			const std::size_t size{ component_offsets[c + 1] - first };
+			size_largest = std::max(size_largest, size);
+			if (size == 1) {
+				++n_trivial;
+				continue;
+			}
+			for (std::size_t i{ 0 }; i < size; ++i) local_index[order[first + i]] = i;
+			const auto for_each_local_entry{ [&](const std::size_t& state, auto callback) {
+				for (auto pos{ matrix.row_begin(static_cast<index_type>(state)) }; pos != matrix.row_end(static_cast<index_type>(state)); ++pos) {
+					const std::size_t column{ static_cast<std::size_t>(matrix.column(pos)) };
+					if (component_of[column] == c) callback(local_index[column], matrix.value(pos));
+				}
+			} };
+			if (size <= dense_max) {
+				std::vector<double> a(size * size, 0.0);
+				for (std::size_t i{ 0 }; i < size; ++i)
+					for_each_local_entry(order[first + i], [&](const std::size_t& j, const double& value) { a[i * size + j] = value; });
+				dense_solvers[c] = std::make_unique<dense_lu>(size, std::move(a));
+				++n_dense;
+				continue;
+			}
+			sparse_matrix block(static_cast<index_type>(size), static_cast<index_type>(size));
+			for (std::size_t i{ 0 }; i < size; ++i) {
+				row.clear();
+				for_each_local_entry(order[first + i], [&](const std::size_t& j, const double& value) { row.emplace_back(static_cast<index_type>(j), value); });
+				std::sort(row.begin(), row.end());
+				for (const auto& [column, value] : row) block.push_back(column, value);
+				block.end_row();
+			}
+			amg_solvers[c] = make_amg_solver(std::move(block), prm);
+			++n_amg;
+		}
+	}
+
+	using solver_engine::operator();
+
+	/// @brief Solves M * x = b component by component and returns x.
+	std::vector<double> operator()(const std::vector<double>& b) const override {
+		using index_type = sparse_matrix::index_type;
+		std::vector<double> x(order.size(), 0.0);
+		std::vector<double> local_b;
+		for (std::size_t c{ 0 }; c + 1 < component_offsets.size(); ++c) {
+			const std::size_t first{ component_offsets[c] };
+			const std::size_t size{ component_offsets[c + 1] - first };
+			if (size == 1) {
+				const std::size_t state{ order[first] };
+				double sum{ b[state] };
+				double diagonal{ 0 };
+				for (auto pos{ matrix.row_begin(static_cast<index_type>(state)) }; pos != matrix.row_end(static_cast<index_type>(state)); ++pos) {
+					const std::size_t column{ static_cast<std::size_t>(matrix.column(pos)) };
+					if (column == state) diagonal = matrix.value(pos);
+					else sum -= matrix.value(pos) * x[column];
+				}
+				if (diagonal == 0) throw std::invalid_argument("Matrix is singular.");
+				x[state] = sum / diagonal;
+				continue;
+			}
+			// move the values of all components solved before to the right-hand side:
+			local_b.assign(size, 0.0);
+			for (std::size_t i{ 0 }; i < size; ++i) {
+				const std::size_t state{ order[first + i] };
+				double sum{ b[state] };
+				for (auto pos{ matrix.row_begin(static_cast<index_type>(state)) }; pos != matrix.row_end(static_cast<index_type>(state)); ++pos) {
+					const std::size_t column{ static_cast<std::size_t>(matrix.column(pos)) };
+					if (component_of[column] != c) sum -= matrix.value(pos) * x[column];
+				}
+				local_b[i] = sum;
+			}
+			const auto local_x{ dense_solvers[c] ? (*dense_solvers[c])(local_b) : (*amg_solvers[c])(local_b) };
+			for (std::size_t i{ 0 }; i < size; ++i) x[order[first + i]] = local_x[i];
+		}
+		return x;
+	}
+
+	nlohmann::json statistics() const override {
+		return {
+			{ sc::number_components, component_offsets.size() - 1 },
+			{ sc::number_components_trivial, n_trivial },
+			{ sc::number_components_dense, n_dense },
+			{ sc::number_components_amg, n_amg },
+			{ sc::size_largest_component, size_largest }
+		};
+	}
+};
+
+/**
+	@brief Solves M * x = b by iterating directly on the rows of M, without setting up any hierarchy or factorization.
+	@details Besides M, the iteration only needs two (\a interval: four) vectors of size n. Rows are split into one chunk per thread, all threads iterate in lock-step.
+	Each sweep solves every row i for x_i using the values x_j of the previous sweep (the diagonal is solved for, which eliminates self-loops):
+	- \a jacobi: uses only values of the previous sweep.
+	- \a gauss_seidel: uses the values of the current sweep for all rows of the own chunk that are already done. With a single thread, this is the classical Gauss-Seidel method.
+	- \a interval: sound interval iteration: Besides x_k (expected values within k steps), it iterates y_k (probabilities of not having left the system within k steps).
+	  The unknown solution is enclosed by x_k + y_k * [L, U] with L = min x_k / (1 - y_k) and U = max x_k / (1 - y_k), see Quatmann and Katoen, Sound Value Iteration, CAV 2018.
+	  The result is the midpoint, which is guaranteed to be within the tolerance unlike for the other methods.
+	Convergence: \a jacobi and \a gauss_seidel stop when no value changed by more than the tolerance during one sweep, \a interval stops when all enclosures are tighter than twice the tolerance.
+	With the relative criterion the tolerance is relative to the value of each state.
+	M must have negative diagonal entries and non-negative entries off the diagonal, like the system matrices built from \a reduce_states, in which all states reach the target almost surely.
+*/
+class iterative_solver : public solver_engine {
+public:
+	enum class method { jacobi, gauss_seidel, interval };
+
+	/// @brief Default tolerance.
+	static constexpr double default_tolerance{ 1e-8 };
+	/// @brief Default maximum number of sweeps.
+	static constexpr std::size_t default_max_iterations{ 1'000'000 };
+	/// @brief Minimum number of non-zero entries per thread.
+	static constexpr std::size_t min_chunk_nonzeros{ 1 << 16 };
+
+private:
+	sparse_matrix matrix;
+	method how;
+	double tolerance;
+	bool relative;
+	std::size_t max_iterations;
+	/// @brief Chunk c consists of rows chunk_offsets[c] ... chunk_offsets[c+1]-1, one chunk per thread.
+	std::vector<std::size_t> chunk_offsets;
+
+	/// @brief Returns (b_i - sum_{j != i} M_ij * x_j) / M_ii where x_j is taken from \a current for j in [\a first, i) and from \a previous otherwise.
+	double solve_row(const std::size_t& i, const double& b_i, const std::vector<double>& previous, const std::vector<double>& current, const std::size_t& first) const {
+		using index_type = sparse_matrix::index_type;
+		double sum{ b_i };
+		double diagonal{ 0 };
+		for (auto pos{ matrix.row_begin(static_cast<index_type>(i)) }; pos != matrix.row_end(static_cast<index_type>(i)); ++pos) {
+			const std::size_t j{ static_cast<std::size_t>(matrix.column(pos)) };
+			if (j == i) diagonal = matrix.value(pos);
+			else sum -= matrix.value(pos) * (first <= j && j < i ? current[j] : previous[j]);
+		}
+		return sum / diagonal;
+	}
+
+	bool close(const double& difference, const double& value) const {
+		return std::abs(difference) <= tolerance * (relative ? std::abs(value) : 1.0);
+	}
+
+	/// @brief Returns the maximum norm of M * x - b.
+	double residual(const std::vector<double>& x, const std::vector<double>& b) const {
+		using index_type = sparse_matrix::index_type;
+		std::vector<double> chunk_residuals(chunk_offsets.size() - 1, 0.0);
+		run_in_parallel(chunk_residuals.size(), [&](const std::size_t& c) {
+			for (std::size_t i{ chunk_offsets[c] }; i < chunk_offsets[c + 1]; ++i) {
+				double sum{ -b[i] };
+				for (auto pos{ matrix.row_begin(static_cast<index_type>(i)) }; pos != matrix.row_end(static_cast<index_type>(i)); ++pos)
+					sum += matrix.value(pos) * x[static_cast<std::size_t>(matrix.column(pos))];
+				chunk_residuals[c] = std::max(chunk_residuals[c], std::abs(sum));
+			}
+			});
+		return *std::max_element(chunk_residuals.cbegin(), chunk_residuals.cend());
+	}
+
+	/// @brief Result of an iteration: x, number of sweeps and whether the convergence criterion was met.
+	using iteration_result = std::tuple<std::vector<double>, std::size_t, bool>;
+
+	/// @brief Runs Jacobi or Gauss-Seidel sweeps until convergence or until the maximum number of sweeps.
+	iteration_result iterate_values(const std::vector<double>& b) const {
+		const std::size_t n_chunks{ chunk_offsets.size() - 1 };
+		std::vector<double> x(b.size(), 0.0), next(b.size(), 0.0);
+		std::vector<char> chunk_converged(n_chunks, false);
+		std::size_t iterations{ 0 };
+		bool converged{ false };
+		bool done{ false };
+		barrier sweep_done(n_chunks, [&] {
+			++iterations;
+			x.swap(next);
+			converged = std::all_of(chunk_converged.cbegin(), chunk_converged.cend(), [](const char& c) { return c; });
+			done = converged || !(iterations < max_iterations);
+			});
+		run_in_parallel(n_chunks, [&](const std::size_t& c) {
+			const std::size_t first{ chunk_offsets[c] };
+			const std::size_t last{ chunk_offsets[c + 1] };
+			const std::size_t own_first{ how == method::gauss_seidel ? first : last };
+			while (!done) {
+				bool chunk_done{ true };
+				for (std::size_t i{ first }; i < last; ++i) {
+					next[i] = solve_row(i, b[i], x, next, own_first);
+					chunk_done = chunk_done && close(next[i] - x[i], next[i]);
+				}
+				chunk_converged[c] = chunk_done;
+				sweep_done.arrive_and_wait();
+			}
+			});
+		return { std::move(x), iterations, converged };
+	}
+
+	/// @brief Runs sound interval iteration until all enclosures are tight enough or until the maximum number of sweeps, x are the midpoints of the enclosures.
+	iteration_result iterate_intervals(const std::vector<double>& b) const {
+		const std::size_t n_chunks{ chunk_offsets.size() - 1 };
+		const std::vector<double> zeros(b.size(), 0.0);
+		std::vector<double> x(b.size(), 0.0), next_x(b.size(), 0.0);
+		std::vector<double> y(b.size(), 1.0), next_y(b.size(), 0.0);
+		std::vector<double> chunk_lower(n_chunks), chunk_upper(n_chunks);
+		std::vector<char> chunk_converged(n_chunks, false);
+		double lower{ -std::numeric_limits<double>::infinity() };
+		double upper{ std::numeric_limits<double>::infinity() };
+		std::size_t iterations{ 0 };
+		bool converged{ false };
+		bool done{ false };
+		barrier sweep_done(n_chunks, [&] {
+			++iterations;
+			x.swap(next_x);
+			y.swap(next_y);
+			lower = std::max(lower, *std::min_element(chunk_lower.cbegin(), chunk_lower.cend()));
+			upper = std::min(upper, *std::max_element(chunk_upper.cbegin(), chunk_upper.cend()));
+			});
+		barrier check_done(n_chunks, [&] {
+			converged = std::all_of(chunk_converged.cbegin(), chunk_converged.cend(), [](const char& c) { return c; });
+			done = converged || !(iterations < max_iterations);
+			});
+		run_in_parallel(n_chunks, [&](const std::size_t& c) {
+			const std::size_t first{ chunk_offsets[c] };
+			const std::size_t last{ chunk_offsets[c + 1] };
+			while (!done) {
+				double local_lower{ std::numeric_limits<double>::infinity() };
+				double local_upper{ -std::numeric_limits<double>::infinity() };
+				for (std::size_t i{ first }; i < last; ++i) {
+					next_x[i] = solve_row(i, b[i], x, next_x, last);
+					next_y[i] = solve_row(i, 0.0, y, next_y, last);
+					if (next_y[i] < 1.0) {
+						local_lower = std::min(local_lower, next_x[i] / (1.0 - next_y[i]));
+						local_upper = std::max(local_upper, next_x[i] / (1.0 - next_y[i]));
+					}
+					else {
+						local_lower = -std::numeric_limits<double>::infinity();
+						local_upper = std::numeric_limits<double>::infinity();
+					}
+				}
+				chunk_lower[c] = local_lower;
+				chunk_upper[c] = local_upper;
+				sweep_done.arrive_and_wait();
+				bool chunk_done{ lower <= upper && upper - lower < std::numeric_limits<double>::infinity() };
+				for (std::size_t i{ first }; chunk_done && i < last; ++i)
+					chunk_done = close(y[i] * (upper - lower) / 2, x[i] + y[i] * (lower + upper) / 2);
+				chunk_converged[c] = chunk_done;
+				check_done.arrive_and_wait();
+			}
+			});
+		if (!(lower <= upper && upper - lower < std::numeric_limits<double>::infinity())) return { std::move(x), iterations, false }; // no enclosure found yet
+		for (std::size_t i{ 0 }; i < x.size(); ++i) x[i] += y[i] * (lower + upper) / 2;
+		return { std::move(x), iterations, converged };
+	}
+
+public:
+	/**
+		@brief Prepares iterating on \a M with given \a how, \a tolerance and maximum number of sweeps.
+		@details Rows are split into chunks of about the same number of non-zero entries, one per thread.
+	*/
+	iterative_solver(sparse_matrix M, const method& how, const double& tolerance, const bool& relative, const std::size_t& max_iterations) :
+		matrix(std::move(M)), how(how), tolerance(tolerance), relative(relative), max_iterations(max_iterations), chunk_offsets()
+	{
+		using index_type = sparse_matrix::index_type;
+		chunk_offsets = split_rows(static_cast<std::size_t>(matrix.size_m()), parallel_task_count(matrix.nonzeros(), min_chunk_nonzeros),
+			[&](const std::size_t& row) { return matrix.row_begin(static_cast<index_type>(row)); });
+	}
+
+	using solver_engine::operator();
+
+	/// @brief Iterates until convergence or until the maximum number of sweeps and returns x.
+	std::vector<double> operator()(const std::vector<double>& b) const override {
+		auto [x, iterations, converged] { how == method::interval ? iterate_intervals(b) : iterate_values(b) };
+		const double error{ residual(x, b) };
+		std::cout << "Iterated linear system:  iterations: " << iterations << "  residual: " << error << std::endl;
+		if (!converged) std::cout << "WARNING:   Iteration stopped without convergence after " << iterations << " iterations." << std::endl;
+		record_solve(iterations, error);
+		return x;
+	}
+
+	nlohmann::json statistics() const override {
+		return { { sc::number_threads, chunk_offsets.size() - 1 } };
+	}
+};
+
+/**
+	@brief Solves M * x = b exactly (up to rounding) by an LU decomposition, which is computed once and reused for every right-hand side b.
+	@details Systems of up to \a dense_max unknowns are factorized densely (see \a dense_lu), which avoids any set-up overhead for tiny markov chains.
+	Bigger systems are factorized by AMGCL's skyline LU, which first reorders M by Cuthill-McKee in order to reduce the profile and thus the fill-in.
+	Memory grows with the profile of the reordered matrix, up to n^2 / 2 values, so this engine is meant for small and medium systems, see \a make_solver_engine.
+*/
+class direct_solver : public solver_engine {
+public:
+	/// @brief Default maximum size of systems solved by dense LU decomposition.
+	static constexpr std::size_t default_dense_max{ 256 };
+
+private:
+	using skyline_lu = amgcl::solver::skyline_lu<sparse_matrix::value_type>;
+
+	sparse_matrix matrix;
+	std::unique_ptr<dense_lu> dense;
+	std::unique_ptr<skyline_lu> skyline;
+
+	/// @brief Returns M as row-major dense matrix.
+	std::vector<double> dense_matrix() const {
+		using index_type = sparse_matrix::index_type;
+		const std::size_t n{ static_cast<std::size_t>(matrix.size_m()) };
+		std::vector<double> a(n * n, 0.0);
+		for (std::size_t i{ 0 }; i < n; ++i)
+			for (auto pos{ matrix.row_begin(static_cast<index_type>(i)) }; pos != matrix.row_end(static_cast<index_type>(i)); ++pos)
+				a[i * n + static_cast<std::size_t>(matrix.column(pos))] = matrix.value(pos);
+		return a;
+	}
+
+	/// @brief Returns the relative residual norm ||b - M * x|| / ||b||, like AMGCL reports it for iterative solvers.
+	double relative_residual(const std::vector<double>& x, const std::vector<double>& b) const {
+		using index_type = sparse_matrix::index_type;
+		double norm_r{ 0 };
+		double norm_b{ 0 };
+		for (std::size_t i{ 0 }; i < b.size(); ++i) {
+			double r{ b[i] };
+			for (auto pos{ matrix.row_begin(static_cast<index_type>(i)) }; pos != matrix.row_end(static_cast<index_type>(i)); ++pos)
+				r -= matrix.value(pos) * x[static_cast<std::size_t>(matrix.column(pos))];
+			norm_r += r * r;
+			norm_b += b[i] * b[i];
+		}
+		return norm_b == 0 ? std::sqrt(norm_r) : std::sqrt(norm_r / norm_b);
+	}
+
+public:
+	/**
+		@brief Factorizes \a M, densely if it has at most \a dense_max rows.
+		@exception std::invalid_argument Matrix is singular (dense factorization only).
+	*/
+	direct_solver(sparse_matrix M, const std::size_t& dense_max = default_dense_max) : matrix(std::move(M)), dense(), skyline() {
+		const std::size_t n{ static_cast<std::size_t>(matrix.size_m()) };
+		if (n <= dense_max) dense = std::make_unique<dense_lu>(n, dense_matrix());
+		else skyline = std::make_unique<skyline_lu>(*matrix.amgcl_matrix());
+	}
+
+	using solver_engine::operator();
+
+	/// @brief Solves M * x = b by forward and backward substitution and returns x.
+	std::vector<double> operator()(const std::vector<double>& b) const override {
+		std::vector<double> x;
+		if (dense) x = (*dense)(b);
+		else {
+			x.assign(b.size(), 0.0);
+			(*skyline)(b, x);
+		}
+		record_solve(0, relative_residual(x, b));
+		return x;
+	}
+
+	nlohmann::json statistics() const override {
+		return { { sc::factorization, dense ? "dense" : "skyline" } };
+	}
+};
+
+/// @brief Solver engine used by \a make_solver_engine if key \a engine is not given.
+constexpr auto default_solver_engine{ "auto" };
+
+/// @brief Returns true if and only if \a engine names a solver engine known by \a make_solver_engine.
+inline bool is_solver_engine(const std::string& engine) {
+	return engine == "auto" || engine == "direct" || engine == "amg" || engine == "scc" || engine == "jacobi" || engine == "gauss_seidel" || engine == "interval";
+}
+
+/**
+	@brief Sets up the engine selected by key \a engine of \a prm for solving M * x = b.
+	@details Engines:
+	- \a auto (default): \a direct for systems of up to \a direct.max_size unknowns (default 10000), \a amg for bigger ones.
+	- \a direct: LU decomposition, dense for up to \a direct.dense_max unknowns (default 256), skyline otherwise, see \a direct_solver.
+	- \a amg: AMG preconditioned Krylov solver on the whole matrix, see \a linear_system_solver. Key \a precision (\a double (default), \a single or \a mixed) selects its scalar type, see \a make_amg_solver.
+	- \a scc: block-wise solving of strongly connected components, see \a scc_block_solver. Key \a scc.dense_max sets the maximum size of components solved by dense LU decomposition.
+	- \a jacobi, \a gauss_seidel, \a interval: iteration on M without AMG, see \a iterative_solver.
+	Keys \a iteration.tol (default 1e-8), \a iteration.criterion (\a relative (default) or \a absolute) and \a iteration.maxiter configure the convergence criterion.
+	The subtrees \a solver and \a precond as well as key \a precision configure AMGCL in all engines using AMG.
+	@exception std::invalid_argument Unknown solver engine.
+	@exception std::invalid_argument Unknown precision.
+*/
+inline std::unique_ptr<solver_engine> make_solver_engine(sparse_matrix M, const solver_parameters& prm) {
+	constexpr std::size_t default_direct_max_size{ 10'000 };
+	auto engine{ prm.get<std::string>("engine", default_solver_engine) };
+	if (engine == "auto")
+		engine = static_cast<std::size_t>(M.size_m()) <= prm.get<std::size_t>("direct.max_size", default_direct_max_size) ? "direct" : "amg";
+	if (engine == "direct") return std::make_unique<direct_solver>(std::move(M), prm.get<std::size_t>("direct.dense_max", direct_solver::default_dense_max));
+	if (engine == "amg") return make_amg_solver(std::move(M), prm);
+	if (engine == "scc") return std::make_unique<scc_block_solver>(std::move(M), prm, prm.get<std::size_t>("scc.dense_max", scc_block_solver::default_dense_max));
+	const auto tolerance{ prm.get<double>("iteration.tol", iterative_solver::default_tolerance) };
+	const auto relative{ prm.get<std::string>("iteration.criterion", "relative") != "absolute" };
+	const auto max_iterations{ prm.get<std::size_t>("iteration.maxiter", iterative_solver::default_max_iterations) };
+	if (engine == "jacobi") return std::make_unique<iterative_solver>(std::move(M), iterative_solver::method::jacobi, tolerance, relative, max_iterations);
+	if (engine == "gauss_seidel") return std::make_unique<iterative_solver>(std::move(M), iterative_solver::method::gauss_seidel, tolerance, relative, max_iterations);
+	if (engine == "interval") return std::make_unique<iterative_solver>(std::move(M), iterative_solver::method::interval, tolerance, relative, max_iterations);
+	throw std::invalid_argument("Unknown solver engine: " + engine);
+}
+
+/**
+	@brief Solver for the target adjusted linear system of one markov chain and one target set, restricted to the states kept by graph-based preprocessing.
+	@details Right-hand sides and results are vectors over all states, they are restricted to the kept states before solving and expanded afterwards, see \a state_reduction.
+	The solver is reused for all right-hand sides. If no state is kept, nothing needs to be solved.
+*/
+class prepared_linear_system {
+	state_reduction reduction;
+	std::optional<std::size_t> initial;
+	solver_parameters prm;
+	std::unique_ptr<solver_engine> solver;
+
+public:
+	/// @brief Sets up the engine selected by \a prm (see \a make_solver_engine) on the system matrix \a M of the states kept by \a reduction.
+	prepared_linear_system(state_reduction reduction, const std::optional<std::size_t>& initial_state, sparse_matrix M, const solver_parameters& prm) :
+		reduction(std::move(reduction)),
+		initial(initial_state),
+		prm(prm),
+		solver(this->reduction.kept.empty() ? nullptr : make_solver_engine(std::move(M), prm))
+	{
+	}
+
+	/// @brief Returns the preprocessing result the system was set up with.
+	const state_reduction& states() const { return reduction; }
+
+	/// @brief Returns the dense index of the initial state the system was set up with, if any.
+	const std::optional<std::size_t>& initial_state() const { return initial; }
+
+	/// @brief Returns the parameters the solver was set up with.
+	const solver_parameters& parameters() const { return prm; }
+
+	/// @brief Returns statistics of the solver engine, see \a solver_engine::statistics().
+	nlohmann::json statistics() const { return solver ? solver->statistics() : nlohmann::json::object(); }
+
+	/// @brief Returns statistics of the solves since the last \a reset_solve_statistics(), see \a solver_engine::solve_statistics().
+	nlohmann::json solve_statistics() const { return solver ? solver->solve_statistics() : nlohmann::json::object(); }
+
+	/// @brief Clears the statistics returned by \a solve_statistics().
+	void reset_solve_statistics() const noexcept { if (solver) solver->reset_solve_statistics(); }
+
+	/// @brief Solves the system for right-hand side \a b over all states and returns the values of all states.
+	std::vector<double> operator()(const std::vector<double>& b) const {
+		if (!solver) return reduction.expand({});
+		return reduction.expand((*solver)(reduction.restrict(b)));
+	}
+
+	/// @brief Solves the system for all right-hand sides \a bs, see \a operator()(const std::vector<double>&).
+	std::vector<std::vector<double>> operator()(const std::vector<std::vector<double>>& bs) const {
+		if (!solver) return std::vector<std::vector<double>>(bs.size(), reduction.expand({}));
+		std::vector<std::vector<double>> reduced_bs;
+		reduced_bs.reserve(bs.size());
+		for (const auto& b : bs) reduced_bs.push_back(reduction.restrict(b));
+		auto xs{ (*solver)(reduced_bs) };
+		for (auto& x : xs) x = reduction.expand(x);
+		return xs;
+	}
+};
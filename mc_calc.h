@@ -7,32 +7,110 @@
 #pragma once
 
 #include "markov_chain.h"
+#include "mc_analyzer.h"
 #include "commands.h"
 
+/**
+	@brief Makes sure that \a system is set up for the target adjusted linear system of \a mc and \a target_set.
+	@details Freezes the markov chain and translates the state ids of \a target_set into dense state indices, stored in \a dense_target_set.
+	If \a system is empty or was set up with parameters other than \a prm or another initial state, states are classified by graph search (see \a reduce_states),
+	the system matrix of the remaining states (target adjusted probability matrix minus unity matrix) is built in one pass and a new solver is set up on it.
+	Otherwise the given system is reused and no matrix is built at all.
+	@param initial_state id of the initial state. If given, states unreachable from it are excluded from the system.
+	@return Log containing the number of threads, the timings of all preparation phases in milliseconds, the sizes of the reduction and statistics of the solver engine.
+	The solve statistics of \a system are reset, so that they only cover the following solves.
+	@exception std::invalid_argument Initial state does not exist in markov chain.
+*/
+template <class _MarkovChain, class _IntegralSet>
+nlohmann::json prepare_linear_system_solver(
+	_MarkovChain& mc,
+	const _IntegralSet& target_set,
+	_IntegralSet& dense_target_set,
+	std::shared_ptr<prepared_linear_system>& system,
+	const solver_parameters& prm,
+	const std::optional<typename _MarkovChain::integral_type>& initial_state) {
+
+	constexpr unsigned COUNT_TIMESTAMPS{ 6 };
+	std::array<decltype(std::chrono::steady_clock::now()), COUNT_TIMESTAMPS> timestamps;
+
+	timestamps[0] = std::chrono::steady_clock::now();
+	mc.freeze();
+	timestamps[1] = std::chrono::steady_clock::now();
+	dense_target_set = mc.dense_state_set(target_set);
+	std::optional<std::size_t> dense_initial_state;
+	if (initial_state) {
+		dense_initial_state = mc.dense_index(*initial_state);
+		if (!(*dense_initial_state < mc.size_states())) throw std::invalid_argument("Initial state does not exist in markov chain.");
+	}
+	timestamps[2] = std::chrono::steady_clock::now();
+
+	const bool cache_hit{ system != nullptr && system->parameters() == prm && system->initial_state() == dense_initial_state };
+	if (cache_hit) {
+		std::fill(timestamps.begin() + 3, timestamps.end(), timestamps[2]);
+	}
+	else {
+		auto reduction{ reduce_states(mc, dense_target_set, dense_initial_state) };
+		timestamps[3] = std::chrono::steady_clock::now();
+		auto system_matrix{ reduced_system_matrix(mc, reduction) };
+		timestamps[4] = std::chrono::steady_clock::now();
+		system = std::make_shared<prepared_linear_system>(std::move(reduction), dense_initial_state, std::move(system_matrix), prm);
+		timestamps[5] = std::chrono::steady_clock::now();
+	}
+
+	static_assert(std::is_same<decltype(timestamps[1] - timestamps[0])::period, std::nano>::value, "Unit is supposed to be nanoseconds.");
+	std::array<double, COUNT_TIMESTAMPS - 1> diffs;
+	std::transform(timestamps.cbegin(),
+		timestamps.cbegin() + (timestamps.size() - 1),
+		timestamps.cbegin() + 1,
+		diffs.begin(),
+		[](auto before, auto after) { return (after - before).count() / 1'000'000.0; }
+	);
+
+	const auto& reduction{ system->states() };
+	nlohmann::json log = {
+		{sc::solver_cache_hit, cache_hit},
+		{sc::solver_parameters, solver_parameters_to_json(prm)},
+		{sc::threads, hardware_threads()},
+		{sc::size_system, reduction.kept.size()},
+		{sc::number_states_target, reduction.n_target},
+		{sc::number_states_infinite, reduction.n_infinite},
+		{sc::number_states_unreachable, reduction.n_unreachable},
+		{sc::time_freeze, diffs[0]},
+		{sc::time_dense_target_set, diffs[1]},
+		{sc::time_reduce_states, diffs[2]},
+		{sc::time_create_pto_matrix, diffs[3]},
+		{sc::time_setup_solver, diffs[4]}
+	};
+	log.update(system->statistics());
+	system->reset_solve_statistics();
+	return log;
+}
+
  /**
 	  Calculates expects of accumulated edge rewards along paths until reaching target_set in markov chain.
+	  @param system Solver for the target adjusted linear system of \a mc and \a target_set. If empty, a new one is set up and stored here for later calculations on the same markov chain and target set.
+	  @param prm Parameters selecting solver engine, Krylov solver, coarsening and relaxation, see \a make_solver_engine.
+	  @param initial_state id of the initial state. If given, only states reachable from it are solved for, see \a prepare_linear_system_solver.
+	  States reaching the target with probability less than 1 get infinity, states excluded as unreachable get NaN.
  */
 template <class _MarkovChain, class _IntegralSet>
-nlohmann::json calc_expect(_MarkovChain& mc, std::size_t reward_index, const _IntegralSet& target_set, std::size_t decoration_destination_index) {
+nlohmann::json calc_expect(_MarkovChain& mc, std::size_t reward_index, const _IntegralSet& target_set, std::size_t decoration_destination_index, std::shared_ptr<prepared_linear_system>& system, const solver_parameters& prm = default_solver_parameters(), const std::optional<typename _MarkovChain::integral_type>& initial_state = std::nullopt) {
 
 	using analyzer = mc_analyzer<typename _MarkovChain::rational_type, typename _MarkovChain::integral_type>;
 
-	constexpr unsigned COUNT_TIMESTAMPS{ 7 };
+	constexpr unsigned COUNT_TIMESTAMPS{ 5 };
 	std::array<decltype(std::chrono::steady_clock::now()), COUNT_TIMESTAMPS> timestamps;
 
 	timestamps[0] = std::chrono::steady_clock::now();
-	auto target_probability_matrix{ target_adjusted_probability_matrix(mc, target_set) };
+	_IntegralSet dense_target_set;
+	const nlohmann::json preparation_log = prepare_linear_system_solver(mc, target_set, dense_target_set, system, prm, initial_state);
 	timestamps[1] = std::chrono::steady_clock::now();
-	auto target_probability_matrix_minus_one{ target_probability_matrix };
+	auto image_vector{ analyzer::rewarded_image_vector(mc, dense_target_set, reward_index) };
 	timestamps[2] = std::chrono::steady_clock::now();
-	target_probability_matrix_minus_one.subtract_unity_matrix();
+	auto result{ (*system)(image_vector) };
 	timestamps[3] = std::chrono::steady_clock::now();
-	auto image_vector{ analyzer::rewarded_image_vector(target_probability_matrix, mc, reward_index) };
-	timestamps[4] = std::chrono::steady_clock::now();
-	auto result{ solve_linear_system(target_probability_matrix_minus_one, image_vector) };
-	timestamps[5] = std::chrono::steady_clock::now();
 	mc.set_decoration(result, decoration_destination_index);
-	timestamps[6] = std::chrono::steady_clock::now();
+	timestamps[4] = std::chrono::steady_clock::now();
 
 	nlohmann::json performance_log;
 	static_assert(std::is_same<decltype(timestamps[1] - timestamps[0])::period, std::nano>::value, "Unit is supposed to be nanoseconds.");
@@ -47,51 +125,114 @@ nlohmann::json calc_expect(_MarkovChain& mc, std::size_t reward_index, const _In
 	performance_log[cli_commands::CALC_EXPECT] = {
 		{sc::decoration_index_egde_source, reward_index },
 		{sc::decoration_index_node_target, decoration_destination_index },
-		{sc::time_create_pto_matrix, diffs[0]},
-		{sc::time_copy_pto_matrix, diffs[1]},
-		{sc::time_subtract_unity_matrix, diffs[2]},
-		{sc::time_calc_image_vector, diffs[3]},
-		{sc::time_solve_linear_system, diffs[4]},
-		{sc::time_write_decoration_node, diffs[5]},
+		{sc::time_prepare_linear_system, diffs[0]},
+		{sc::time_calc_image_vector, diffs[1]},
+		{sc::time_solve_linear_system, diffs[2]},
+		{sc::time_write_decoration_node, diffs[3]},
+		{sc::time_total, (timestamps[COUNT_TIMESTAMPS - 1] - timestamps[0]).count() / 1'000'000.0},
+		{sc::unit, sc::milliseconds}
+	};
+	performance_log[cli_commands::CALC_EXPECT].update(preparation_log);
+	performance_log[cli_commands::CALC_EXPECT].update(system->solve_statistics());
+	return performance_log;
+}
+
+/**
+	Calculates expects of several accumulated edge rewards along paths until reaching target_set in markov chain.
+	All rewards share one system matrix and one solver set-up. Their image vectors are calculated in one pass over all transitions.
+	@param reward_and_destination_indices Pairs of (transition decoration index of the reward, state decoration index where to store the expects).
+	@param system Solver for the target adjusted linear system of \a mc and \a target_set. If empty, a new one is set up and stored here for later calculations on the same markov chain and target set.
+	@param prm Parameters selecting solver engine, Krylov solver, coarsening and relaxation, see \a make_solver_engine.
+	@param initial_state id of the initial state. If given, only states reachable from it are solved for, see \a calc_expect.
+*/
+template <class _MarkovChain, class _IntegralSet>
+nlohmann::json calc_expect_multi(
+	_MarkovChain& mc,
+	const std::vector<std::pair<std::size_t, std::size_t>>& reward_and_destination_indices,
+	const _IntegralSet& target_set,
+	std::shared_ptr<prepared_linear_system>& system,
+	const solver_parameters& prm = default_solver_parameters(),
+	const std::optional<typename _MarkovChain::integral_type>& initial_state = std::nullopt) {
+
+	using analyzer = mc_analyzer<typename _MarkovChain::rational_type, typename _MarkovChain::integral_type>;
+
+	std::vector<std::size_t> reward_indices, destination_indices;
+	for (const auto& pair : reward_and_destination_indices) {
+		reward_indices.push_back(pair.first);
+		destination_indices.push_back(pair.second);
+	}
+
+	constexpr unsigned COUNT_TIMESTAMPS{ 5 };
+	std::array<decltype(std::chrono::steady_clock::now()), COUNT_TIMESTAMPS> timestamps;
+
+	timestamps[0] = std::chrono::steady_clock::now();
+	_IntegralSet dense_target_set;
+	const nlohmann::json preparation_log = prepare_linear_system_solver(mc, target_set, dense_target_set, system, prm, initial_state);
+	timestamps[1] = std::chrono::steady_clock::now();
+	const auto image_vectors{ analyzer::rewarded_image_vectors(mc, dense_target_set, reward_indices) };
+	timestamps[2] = std::chrono::steady_clock::now();
+	const auto results{ (*system)(image_vectors) };
+	timestamps[3] = std::chrono::steady_clock::now();
+	for (std::size_t i{ 0 }; i != results.size(); ++i)
+		mc.set_decoration(results[i], destination_indices[i]);
+	timestamps[4] = std::chrono::steady_clock::now();
+
+	nlohmann::json performance_log;
+	static_assert(std::is_same<decltype(timestamps[1] - timestamps[0])::period, std::nano>::value, "Unit is supposed to be nanoseconds.");
+	std::array<double, COUNT_TIMESTAMPS - 1> diffs;
+	std::transform(timestamps.cbegin(),
+		timestamps.cbegin() + (timestamps.size() - 1),
+		timestamps.cbegin() + 1,
+		diffs.begin(),
+		[](auto before, auto after) { return (after - before).count() / 1'000'000.0; }
+	);
+
+	performance_log[cli_commands::CALC_EXPECT_MULTI] = {
+		{sc::decoration_index_egde_source, reward_indices },
+		{sc::decoration_index_node_target, destination_indices },
+		{sc::time_prepare_linear_system, diffs[0]},
+		{sc::time_calc_image_vector, diffs[1]},
+		{sc::time_solve_linear_system, diffs[2]},
+		{sc::time_write_decoration_node, diffs[3]},
 		{sc::time_total, (timestamps[COUNT_TIMESTAMPS - 1] - timestamps[0]).count() / 1'000'000.0},
 		{sc::unit, sc::milliseconds}
 	};
+	performance_log[cli_commands::CALC_EXPECT_MULTI].update(preparation_log);
+	performance_log[cli_commands::CALC_EXPECT_MULTI].update(system->solve_statistics());
 	return performance_log;
-	//### reuse this code where variances are calculated?
 }
 
 /**
 	Calculates variances of accumulated edge rewards along paths until reaching target_set in markov chain.
+	The image vector for the variances is calculated from the expects in one pass over all transitions (see \a mc_analyzer::variance_image_vector), without storing anything per transition.
+	@param system Solver for the target adjusted linear system of \a mc and \a target_set. If empty, a new one is set up and stored here for later calculations on the same markov chain and target set.
+	@param prm Parameters selecting solver engine, Krylov solver, coarsening and relaxation, see \a make_solver_engine.
+	@param initial_state id of the initial state. If given, only states reachable from it are solved for, see \a calc_expect.
 */
 template <class _MarkovChain, class _IntegralSet>
-nlohmann::json calc_variance(_MarkovChain& mc, std::size_t reward_index, const _IntegralSet& target_set, std::size_t decoration_destination_index, std::size_t expect_decoration_index, std::size_t free_reward_index) {
+nlohmann::json calc_variance(_MarkovChain& mc, std::size_t reward_index, const _IntegralSet& target_set, std::size_t decoration_destination_index, std::size_t expect_decoration_index, std::shared_ptr<prepared_linear_system>& system, const solver_parameters& prm = default_solver_parameters(), const std::optional<typename _MarkovChain::integral_type>& initial_state = std::nullopt) {
 
 	using analyzer = mc_analyzer<typename _MarkovChain::rational_type, typename _MarkovChain::integral_type>;
 
-	constexpr unsigned COUNT_TIMESTAMPS{ 11 };
+	constexpr unsigned COUNT_TIMESTAMPS{ 8 };
 	std::array<decltype(std::chrono::steady_clock::now()), COUNT_TIMESTAMPS> timestamps;
 
 	timestamps[0] = std::chrono::steady_clock::now();
-	auto target_probability_matrix{ target_adjusted_probability_matrix(mc, target_set) };
+	_IntegralSet dense_target_set;
+	const nlohmann::json preparation_log = prepare_linear_system_solver(mc, target_set, dense_target_set, system, prm, initial_state);
 	timestamps[1] = std::chrono::steady_clock::now();
-	auto target_probability_matrix_minus_one{ target_probability_matrix };
+	auto image_vector{ analyzer::rewarded_image_vector(mc, dense_target_set, reward_index) };
 	timestamps[2] = std::chrono::steady_clock::now();
-	target_probability_matrix_minus_one.subtract_unity_matrix();
+	auto result{ (*system)(image_vector) };
 	timestamps[3] = std::chrono::steady_clock::now();
-	auto image_vector{ analyzer::rewarded_image_vector(target_probability_matrix,mc,reward_index) };
+	mc.set_decoration(result, expect_decoration_index);
 	timestamps[4] = std::chrono::steady_clock::now();
-	auto result{ solve_linear_system(target_probability_matrix_minus_one, image_vector) };
+	auto image_vector2{ analyzer::variance_image_vector(mc, dense_target_set, reward_index, result) };
 	timestamps[5] = std::chrono::steady_clock::now();
-	mc.set_decoration(result, expect_decoration_index);
+	auto result2{ (*system)(image_vector2) };
 	timestamps[6] = std::chrono::steady_clock::now();
-	analyzer::calculate_variance_reward(mc, reward_index, expect_decoration_index, free_reward_index);
-	timestamps[7] = std::chrono::steady_clock::now();
-	auto image_vector2{ analyzer::rewarded_image_vector(target_probability_matrix, mc, free_reward_index) };
-	timestamps[8] = std::chrono::steady_clock::now();
-	auto result2{ solve_linear_system(target_probability_matrix_minus_one, image_vector2) };
-	timestamps[9] = std::chrono::steady_clock::now();
 	mc.set_decoration(result2, decoration_destination_index);
-	timestamps[10] = std::chrono::steady_clock::now();
+	timestamps[7] = std::chrono::steady_clock::now();
 
 	nlohmann::json performance_log;
 	static_assert(std::is_same<decltype(timestamps[1] - timestamps[0])::period, std::nano>::value, "Unit is supposed to be nanoseconds.");
@@ -105,29 +246,31 @@ nlohmann::json calc_variance(_MarkovChain& mc, std::size_t reward_index, const _
 
 	performance_log[cli_commands::CALC_VARIANCE] = {
 		{sc::decoration_index_egde_source, reward_index },
-		{sc::decoration_index_egde_free, free_reward_index },
 		{sc::decoration_index_node_target + sc::_expect, expect_decoration_index },
 		{sc::decoration_index_node_target + sc::_variance, decoration_destination_index },
-		{sc::time_create_pto_matrix, diffs[0]},
-		{sc::time_copy_pto_matrix, diffs[1]},
-		{sc::time_subtract_unity_matrix, diffs[2]},
-		{sc::time_calc_image_vector + sc::_expect, diffs[3]},
-		{sc::time_solve_linear_system + sc::_expect, diffs[4]},
-		{sc::time_write_decoration_node + sc::_expect, diffs[5]},
-		{sc::time_calc_interim_reward, diffs[6]},
-		{sc::time_calc_image_vector + sc::_variance, diffs[7]},
-		{sc::time_solve_linear_system + sc::_variance, diffs[8]},
-		{sc::time_write_decoration_node + sc::_variance, diffs[9]},
+		{sc::time_prepare_linear_system, diffs[0]},
+		{sc::time_calc_image_vector + sc::_expect, diffs[1]},
+		{sc::time_solve_linear_system + sc::_expect, diffs[2]},
+		{sc::time_write_decoration_node + sc::_expect, diffs[3]},
+		{sc::time_calc_image_vector + sc::_variance, diffs[4]},
+		{sc::time_solve_linear_system + sc::_variance, diffs[5]},
+		{sc::time_write_decoration_node + sc::_variance, diffs[6]},
 		{sc::time_total, (timestamps[COUNT_TIMESTAMPS - 1] - timestamps[0]).count() / 1'000'000.0},
-		{sc::time_solve_linear_system, diffs[4] + diffs[8] },
+		{sc::time_solve_linear_system, diffs[2] + diffs[5] },
 		{sc::unit, sc::milliseconds}
 	};
+	performance_log[cli_commands::CALC_VARIANCE].update(preparation_log);
+	performance_log[cli_commands::CALC_VARIANCE].update(system->solve_statistics());
 	return performance_log;
 }
 
 
 /**
 	Calculates covariances of accumulated edge rewards along paths until reaching target_set in markov chain.
+	The image vector for the covariances is calculated from both expects in one pass over all transitions (see \a mc_analyzer::covariance_image_vector), without storing anything per transition.
+	@param system Solver for the target adjusted linear system of \a mc and \a target_set. If empty, a new one is set up and stored here for later calculations on the same markov chain and target set.
+	@param prm Parameters selecting solver engine, Krylov solver, coarsening and relaxation, see \a make_solver_engine.
+	@param initial_state id of the initial state. If given, only states reachable from it are solved for, see \a calc_expect.
 */
 template <class _MarkovChain, class _IntegralSet>
 nlohmann::json calc_covariance(
@@ -138,43 +281,32 @@ nlohmann::json calc_covariance(
 	std::size_t decoration_destination_index,
 	std::size_t expect_decoration_index1,
 	std::size_t expect_decoration_index2,
-	std::size_t free_reward_index) {
+	std::shared_ptr<prepared_linear_system>& system,
+	const solver_parameters& prm = default_solver_parameters(),
+	const std::optional<typename _MarkovChain::integral_type>& initial_state = std::nullopt) {
 
 	using analyzer = mc_analyzer<typename _MarkovChain::rational_type, typename _MarkovChain::integral_type>;
 
-	constexpr unsigned COUNT_TIMESTAMPS{ 11 };
+	constexpr unsigned COUNT_TIMESTAMPS{ 8 };
 	std::array<decltype(std::chrono::steady_clock::now()), COUNT_TIMESTAMPS> timestamps;
 
 	timestamps[0] = std::chrono::steady_clock::now();
-	auto target_probability_matrix{ target_adjusted_probability_matrix(mc, target_set) };
+	_IntegralSet dense_target_set;
+	const nlohmann::json preparation_log = prepare_linear_system_solver(mc, target_set, dense_target_set, system, prm, initial_state);
 	timestamps[1] = std::chrono::steady_clock::now();
-	auto target_probability_matrix_minus_one{ target_probability_matrix };
+	const auto image_vectors{ analyzer::rewarded_image_vectors(mc, dense_target_set, { reward_index1, reward_index2 }) };
 	timestamps[2] = std::chrono::steady_clock::now();
-	target_probability_matrix_minus_one.subtract_unity_matrix();
+	const auto interims{ (*system)(image_vectors) };
 	timestamps[3] = std::chrono::steady_clock::now();
-	auto image_vector1{ analyzer::rewarded_image_vector(target_probability_matrix,mc,reward_index1) };
-	auto image_vector2{ analyzer::rewarded_image_vector(target_probability_matrix,mc,reward_index2) };
+	mc.set_decoration(interims[0], expect_decoration_index1);
+	mc.set_decoration(interims[1], expect_decoration_index2);
 	timestamps[4] = std::chrono::steady_clock::now();
-	auto interim1{ solve_linear_system(target_probability_matrix_minus_one, image_vector1) };
-	auto interim2{ solve_linear_system(target_probability_matrix_minus_one, image_vector2) };
+	auto image_vector_cov{ analyzer::covariance_image_vector(mc, dense_target_set, reward_index1, reward_index2, interims[0], interims[1]) };
 	timestamps[5] = std::chrono::steady_clock::now();
-	mc.set_decoration(interim1, expect_decoration_index1);
-	mc.set_decoration(interim2, expect_decoration_index2);
+	auto result{ (*system)(image_vector_cov) };
 	timestamps[6] = std::chrono::steady_clock::now();
-	analyzer::calculate_covariance_reward(
-		mc, 
-		reward_index1,
-		reward_index2,
-		expect_decoration_index1,
-		expect_decoration_index2,
-		free_reward_index);
-	timestamps[7] = std::chrono::steady_clock::now();
-	auto image_vector_cov{ analyzer::rewarded_image_vector(target_probability_matrix, mc, free_reward_index) };
-	timestamps[8] = std::chrono::steady_clock::now();
-	auto result{ solve_linear_system(target_probability_matrix_minus_one, image_vector_cov) };
-	timestamps[9] = std::chrono::steady_clock::now();
 	mc.set_decoration(result, decoration_destination_index);
-	timestamps[10] = std::chrono::steady_clock::now();
+	timestamps[7] = std::chrono::steady_clock::now();
 
 	nlohmann::json performance_log;
 	static_assert(std::is_same<decltype(timestamps[1] - timestamps[0])::period, std::nano>::value, "Unit is supposed to be nanoseconds.");
@@ -192,23 +324,21 @@ nlohmann::json calc_covariance(
 	performance_log[cli_commands::CALC_VARIANCE] = {
 		{sc::decoration_index_egde_source + _1, reward_index1 },
 		{sc::decoration_index_egde_source + _2, reward_index2 },
-		{sc::decoration_index_egde_free, free_reward_index },
 		{sc::decoration_index_node_target + sc::_expect +_1, expect_decoration_index1 },
 		{sc::decoration_index_node_target + sc::_expect + _2, expect_decoration_index2 },
 		{sc::decoration_index_node_target + sc::_covariance, decoration_destination_index },
-		{sc::time_create_pto_matrix, diffs[0]},
-		{sc::time_copy_pto_matrix, diffs[1]},
-		{sc::time_subtract_unity_matrix, diffs[2]},
-		{sc::time_calc_image_vector + sc::_expect, diffs[3]},
-		{sc::time_solve_linear_system + sc::_expect, diffs[4]},
-		{sc::time_write_decoration_node + sc::_expect, diffs[5]},
-		{sc::time_calc_interim_reward, diffs[6]},
-		{sc::time_calc_image_vector + sc::_covariance, diffs[7]},
-		{sc::time_solve_linear_system + sc::_covariance, diffs[8]},
-		{sc::time_write_decoration_node + sc::_covariance, diffs[9]},
+		{sc::time_prepare_linear_system, diffs[0]},
+		{sc::time_calc_image_vector + sc::_expect, diffs[1]},
+		{sc::time_solve_linear_system + sc::_expect, diffs[2]},
+		{sc::time_write_decoration_node + sc::_expect, diffs[3]},
+		{sc::time_calc_image_vector + sc::_covariance, diffs[4]},
+		{sc::time_solve_linear_system + sc::_covariance, diffs[5]},
+		{sc::time_write_decoration_node + sc::_covariance, diffs[6]},
 		{sc::time_total, (timestamps[COUNT_TIMESTAMPS - 1] - timestamps[0]).count() / 1'000'000.0},
-		{sc::time_solve_linear_system, diffs[4] + diffs[8] },
+		{sc::time_solve_linear_system, diffs[2] + diffs[5] },
 		{sc::unit, sc::milliseconds}
 	};
+	performance_log[cli_commands::CALC_VARIANCE].update(preparation_log);
+	performance_log[cli_commands::CALC_VARIANCE].update(system->solve_statistics());
 	return performance_log;
 }
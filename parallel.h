@@ -0,0 +1,158 @@
+/**
+ * @file parallel.h
+ *
+ * Helpers for running independent tasks on all cores.
+ *
+ */
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/// @brief Number of threads set by \a set_thread_count(), 0 means one per core.
+inline std::size_t& configured_thread_count() noexcept {
+	static std::size_t n{ 0 };
+	return n;
+}
+
+/// @brief Returns the number of threads to use for parallel work, at least 1: the number set by \a set_thread_count() or one per core.
+inline std::size_t hardware_threads() {
+	if (configured_thread_count()) return configured_thread_count();
+	const auto n{ std::thread::hardware_concurrency() };
+	return n ? n : 1;
+}
+
+/**
+	@brief Limits all parallel work to \a n threads, 0 means one thread per core.
+	@details Applies to the own parallel stages as well as to AMGCL if built with OpenMP. Must not be called while parallel work is running.
+*/
+inline void set_thread_count(const std::size_t& n) {
+	configured_thread_count() = n;
+#ifdef _OPENMP
+	omp_set_num_threads(static_cast<int>(hardware_threads()));
+#endif
+}
+
+/**
+	@brief Returns the number of tasks for parallel work on \a n_items items: one per thread, but each task gets at least about \a min_items_per_task items.
+*/
+inline std::size_t parallel_task_count(const std::size_t& n_items, const std::size_t& min_items_per_task = 1 << 16) {
+	return std::min(hardware_threads(), n_items / min_items_per_task + 1);
+}
+
+/**
+	@brief Splits rows [0, \a n_rows) into at most \a n_chunks consecutive chunks of about the same number of entries, e.g. the rows of a CSR matrix.
+	@details \a row_begin(i) must return the number of entries of all rows before row i and must be non-decreasing for i in [0, \a n_rows].
+	@return Chunk boundaries: chunk c consists of rows result[c] ... result[c+1]-1. Chunks are not empty unless \a n_rows is zero.
+*/
+template<class _RowBegin>
+std::vector<std::size_t> split_rows(const std::size_t& n_rows, const std::size_t& n_chunks, _RowBegin&& row_begin) {
+	std::vector<std::size_t> bounds{ 0 };
+	const std::size_t n_entries{ static_cast<std::size_t>(row_begin(n_rows)) };
+	for (std::size_t c{ 1 }; c < n_chunks; ++c) {
+		// first row that begins at or after c / n_chunks of all entries:
+		const std::size_t share{ n_entries / n_chunks * c + n_entries % n_chunks * c / n_chunks };
+		std::size_t low{ bounds.back() + 1 };
+		std::size_t high{ n_rows };
+		while (low < high) {
+			const std::size_t middle{ low + (high - low) / 2 };
+			if (static_cast<std::size_t>(row_begin(middle)) < share) low = middle + 1;
+			else high = middle;
+		}
+		if (!(low < n_rows)) break;
+		bounds.push_back(low);
+	}
+	bounds.push_back(n_rows);
+	return bounds;
+}
+
+/**
+	@brief Calls \a task(i) for each i in [0, \a n_tasks), each on its own thread, and waits for all of them.
+	@details If tasks throw, the exception of the task with the lowest index is rethrown after all threads have finished.
+	This way errors are reported the same as if the tasks had been run one after another.
+*/
+template<class _Task>
+void run_in_parallel(const std::size_t& n_tasks, _Task&& task) {
+	if (n_tasks == 0) return;
+	if (n_tasks == 1) {
+		task(std::size_t(0));
+		return;
+	}
+	std::vector<std::exception_ptr> errors(n_tasks);
+	std::vector<std::thread> threads;
+	threads.reserve(n_tasks);
+	auto run_task = [&](std::size_t i) {
+		try {
+			task(i);
+		}
+		catch (...) {
+			errors[i] = std::current_exception();
+		}
+	};
+	try {
+		for (std::size_t i{ 1 }; i < n_tasks; ++i)
+			threads.emplace_back(run_task, i);
+	}
+	catch (...) {
+		for (auto& thread : threads)
+			thread.join();
+		throw;
+	}
+	run_task(0); // the calling thread takes the first task
+	for (auto& thread : threads)
+		thread.join();
+	for (const auto& error : errors)
+		if (error) std::rethrow_exception(error);
+}
+
+/**
+	@brief Calls \a task(first, last) for consecutive chunks [first, last) of [0, \a n_items) of about the same size, in parallel.
+	@details Each chunk gets at least about \a min_items_per_task items, see \a parallel_task_count.
+*/
+template<class _Task>
+void for_each_chunk(const std::size_t& n_items, _Task&& task, const std::size_t& min_items_per_task = 1 << 16) {
+	const std::size_t n_tasks{ parallel_task_count(n_items, min_items_per_task) };
+	run_in_parallel(n_tasks, [&](const std::size_t& i) { task(n_items * i / n_tasks, n_items * (i + 1) / n_tasks); });
+}
+
+/**
+	@brief Synchronization point for a fixed number of threads, which can be passed repeatedly, like std::barrier of C++20.
+	@details Each call of \a arrive_and_wait() blocks until all threads have arrived. The last arriving thread calls the completion function before all threads are released,
+	so that the completion function may combine the results of all threads and prepare the next phase without any further synchronization.
+	The completion function must not throw.
+*/
+class barrier {
+	std::mutex mutex;
+	std::condition_variable released;
+	const std::size_t n_threads;
+	std::size_t n_arrived;
+	std::size_t generation;
+	std::function<void()> completion;
+
+public:
+	/// @brief Creates a barrier for \a n_threads threads calling \a completion on each passing.
+	barrier(const std::size_t& n_threads, std::function<void()> completion) : mutex(), released(), n_threads(n_threads), n_arrived(0), generation(0), completion(std::move(completion)) {}
+
+	/// @brief Blocks until all threads have arrived and the completion function has returned.
+	void arrive_and_wait() {
+		std::unique_lock<std::mutex> lock(mutex);
+		const std::size_t my_generation{ generation };
+		if (++n_arrived == n_threads) {
+			completion();
+			n_arrived = 0;
+			++generation;
+			released.notify_all();
+			return;
+		}
+		released.wait(lock, [&] { return generation != my_generation; });
+	}
+};
@@ -13,90 +13,154 @@
 #include <amgcl/coarsening/aggregation.hpp>
 #include <amgcl/relaxation/spai0.hpp>
 #include <amgcl/solver/cg.hpp>
+#include <amgcl/coarsening/runtime.hpp>
+#include <amgcl/relaxation/runtime.hpp>
+#include <amgcl/solver/runtime.hpp>
+#include <amgcl/solver/skyline_lu.hpp>
 #include <amgcl/profiler.hpp>
+#include <amgcl/adapter/zero_copy.hpp>
 
 #include <vector>
-#include <unordered_map>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
 
 
 /**
-	@brief Simple sparse matrix implementation to be used with AMGCL sparse linear system solver.
-*/ //## make this class template, recheck all usages! -> rational type and int type
-class sparse_matrix {
+	@brief Simple sparse matrix implementation in compressed sparse row (CSR) format to be used with AMGCL sparse linear system solver.
+	@details The matrix is built row by row in one linear pass via \a push_back() and \a end_row(), with ascending columns within each row.
+	Index type is \a std::ptrdiff_t, so that AMGCL can use the arrays directly without copying them (see \a amgcl_matrix()).
+	@tparam _ValueT type of the entries, e.g. float in order to halve the memory (and memory bandwidth) of the values.
+*/
+template<class _ValueT>
+class basic_sparse_matrix {
 public:
-	typedef std::unordered_map<int, double> sparse_row;
+	using index_type = std::ptrdiff_t;
+	using value_type = _ValueT;
 
 private:
-	int m, n;
-	std::vector<sparse_row> rows;
+	index_type m, n;
+	std::vector<index_type> row_offsets;
+	std::vector<index_type> columns;
+	std::vector<value_type> values;
 
 public:
 	using size_t = decltype(m);
 
-	sparse_matrix(int mm, int nn) : m(mm), n(nn), rows(mm) { }
+	/**
+		@brief Creates an empty matrix of size \a mm x \a nn.
+		@details Space is reserved for \a nnz_hint non-zero entries. Rows have to be filled by \a push_back() and \a end_row().
+	*/
+	basic_sparse_matrix(index_type mm, index_type nn, std::size_t nnz_hint = 0) : m(mm), n(nn), row_offsets(), columns(), values() {
+		row_offsets.reserve(m + 1);
+		row_offsets.push_back(0);
+		columns.reserve(nnz_hint);
+		values.reserve(nnz_hint);
+	}
+
+	/**
+		@brief Creates a complete matrix of size \a mm x \a nn from its CSR arrays, e.g. after filling them in parallel.
+		@exception std::invalid_argument Arrays do not form a matrix of size \a mm x \a nn.
+	*/
+	basic_sparse_matrix(index_type mm, index_type nn, std::vector<index_type> row_offsets, std::vector<index_type> columns, std::vector<value_type> values)
+		: m(mm), n(nn), row_offsets(std::move(row_offsets)), columns(std::move(columns)), values(std::move(values)) {
+		if (static_cast<index_type>(this->row_offsets.size()) != m + 1 || this->row_offsets.front() != 0
+			|| static_cast<std::size_t>(this->row_offsets.back()) != this->columns.size() || this->columns.size() != this->values.size())
+			throw std::invalid_argument("CSR arrays do not match the size of the matrix.");
+	}
 
-	int size_m() const { return m; }
-	int size_n() const { return n; }
+	index_type size_m() const { return m; }
+	index_type size_n() const { return n; }
 
+	/// @brief Returns the number of non-zero entries.
+	std::size_t nonzeros() const { return values.size(); }
 
-	// Get a value at row i and column j
-	double operator()(int i, int j) const {
-		const sparse_row::const_iterator elem{ rows[i].find(j) };
-		return elem == rows[i].end() ? 0.0 : elem->second;
+	/// @brief Appends an entry to the current row. Columns must be appended in ascending order.
+	inline void push_back(index_type column, value_type value) {
+		columns.push_back(column);
+		values.push_back(value);
 	}
 
-	// Get reference to a value at row i and column j
-	double& operator()(int i, int j) { return rows[i][j]; }
+	/// @brief Finishes the current row and starts the next one.
+	inline void end_row() {
+		if (!(static_cast<index_type>(row_offsets.size()) <= m)) throw std::logic_error("Matrix has no more rows.");
+		row_offsets.push_back(columns.size());
+	}
+
+	/// @brief Returns true if and only if all \a size_m() rows have been finished.
+	bool complete() const { return static_cast<index_type>(row_offsets.size()) == m + 1; }
+
+	/// @brief Position of the first entry of row \a i.
+	index_type row_begin(index_type i) const { return row_offsets[i]; }
+	/// @brief Position behind the last entry of row \a i.
+	index_type row_end(index_type i) const { return row_offsets[i + 1]; }
+	/// @brief Column of the entry at position \a pos.
+	index_type column(index_type pos) const { return columns[pos]; }
+	/// @brief Value of the entry at position \a pos.
+	value_type value(index_type pos) const { return values[pos]; }
+
+	// Get a value at row i and column j
+	value_type operator()(index_type i, index_type j) const {
+		const auto row_first{ columns.cbegin() + row_begin(i) };
+		const auto row_last{ columns.cbegin() + row_end(i) };
+		const auto it{ std::lower_bound(row_first, row_last, j) };
+		return (it == row_last || *it != j) ? 0.0 : values[it - columns.cbegin()];
+	}
 
-	// Access the whole row
-	const sparse_row& operator[](int i) const { return rows[i]; }
+	/// @brief Returns a copy of this matrix with all values converted to \a _OtherT.
+	template<class _OtherT>
+	basic_sparse_matrix<_OtherT> converted() const {
+		return basic_sparse_matrix<_OtherT>(m, n, row_offsets, columns, std::vector<_OtherT>(values.cbegin(), values.cend()));
+	}
 
 	/**
-		@brief Subtracts the unity martix.
+		@brief Returns a matrix in AMGCL's internal format that shares the arrays of this matrix without copying them.
+		@details The returned matrix must not be used after this matrix has been modified or destroyed.
 	*/
-	inline void subtract_unity_matrix() {
-		if (size_m() != size_n()) throw std::invalid_argument("Matrix is not quadratic.");
-		for (sparse_matrix::size_t it{ 0 }; it != size_m(); ++it) rows[it][it] -= 1;
+	std::shared_ptr<amgcl::backend::crs<value_type>> amgcl_matrix() const {
+		if (!complete()) throw std::logic_error("Matrix is not complete.");
+		return amgcl::adapter::zero_copy(m, row_offsets.data(), columns.data(), values.data());
 	}
 
 };
 
+/// @brief Sparse matrix of double values, used for all system matrices unless stated otherwise.
+using sparse_matrix = basic_sparse_matrix<double>;
+
 
 
-/* Define type traits required by amgcl for own class sparse_matrix */
+/* Define type traits required by amgcl for own class basic_sparse_matrix */
 namespace amgcl {
 	namespace backend {
 
 		// Let AMGCL know the value type of our matrix:
-		template <> struct value_type<sparse_matrix> {
-			typedef double type;
+		template <class T> struct value_type<basic_sparse_matrix<T>> {
+			typedef T type;
 		};
 
 		// Let AMGCL know the size of our matrix:
-		template<> struct rows_impl<sparse_matrix> {
-			static int get(const sparse_matrix& A) { return A.size_m(); }
+		template <class T> struct rows_impl<basic_sparse_matrix<T>> {
+			static typename basic_sparse_matrix<T>::index_type get(const basic_sparse_matrix<T>& A) { return A.size_m(); }
 		};
 
-		template<> struct cols_impl<sparse_matrix> {
-			static int get(const sparse_matrix& A) { return A.size_n(); }
+		template <class T> struct cols_impl<basic_sparse_matrix<T>> {
+			static typename basic_sparse_matrix<T>::index_type get(const basic_sparse_matrix<T>& A) { return A.size_n(); }
 		};
 
-		template<> struct nonzeros_impl<sparse_matrix> {
-			static int get(const sparse_matrix& A) {
-				int m = A.size_m(), nnz = 0;
-				for (int i = 0; i < m; ++i)
-					nnz += A[i].size();
-				return nnz;
+		template <class T> struct nonzeros_impl<basic_sparse_matrix<T>> {
+			static std::size_t get(const basic_sparse_matrix<T>& A) {
+				return A.nonzeros();
 			}
 		};
 
 		// Allow AMGCL to iterate over the rows of our matrix:
-		template<> struct row_iterator<sparse_matrix> {
+		template <class T> struct row_iterator<basic_sparse_matrix<T>> {
 			struct iterator {
-				sparse_matrix::sparse_row::const_iterator _it, _end;
+				const basic_sparse_matrix<T>* A;
+				typename basic_sparse_matrix<T>::index_type _it, _end;
 
-				iterator(const sparse_matrix& A, int row)
-					: _it(A[row].begin()), _end(A[row].end()) { }
+				iterator(const basic_sparse_matrix<T>& A, typename basic_sparse_matrix<T>::index_type row)
+					: A(&A), _it(A.row_begin(row)), _end(A.row_end(row)) { }
 
 				// Check if we are at the end of the row.
 				operator bool() const {
@@ -110,18 +174,18 @@ namespace amgcl {
 				}
 
 				// Column number of the current nonzero element.
-				int col() const { return _it->first; }
+				typename basic_sparse_matrix<T>::index_type col() const { return A->column(_it); }
 
 				// Value of the current nonzero element.
-				double value() const { return _it->second; }
+				T value() const { return A->value(_it); }
 			};
 
 			typedef iterator type;
 		};
 
-		template<> struct row_begin_impl<sparse_matrix> {
-			typedef row_iterator<sparse_matrix>::type iterator;
-			static iterator get(const sparse_matrix& A, int row) {
+		template <class T> struct row_begin_impl<basic_sparse_matrix<T>> {
+			typedef typename row_iterator<basic_sparse_matrix<T>>::type iterator;
+			static iterator get(const basic_sparse_matrix<T>& A, typename basic_sparse_matrix<T>::index_type row) {
 				return iterator(A, row);
 			}
 		};
@@ -12,23 +12,48 @@ struct sc {
 	inline static const auto decoration_index{ std::string("deco_index") };
 	inline static const auto decoration_index_node_target{ std::string("deco_index_node_target") };
 	inline static const auto decoration_index_egde_source{ std::string("deco_index_egde_source") };
-	inline static const auto decoration_index_egde_free{ std::string("deco_index_egde_free") };
 	inline static const auto prism_label_id{ std::string("prism_label_id") };
+	inline static const auto size_target_set{ std::string("size_ts") };
+	inline static const auto size_system{ std::string("size_system") };
+	inline static const auto number_states_target{ std::string("n_states_target") };
+	inline static const auto number_states_infinite{ std::string("n_states_infinite") };
+	inline static const auto number_states_unreachable{ std::string("n_states_unreachable") };
+	inline static const auto number_components{ std::string("n_components") };
+	inline static const auto number_components_trivial{ std::string("n_components_trivial") };
+	inline static const auto number_components_dense{ std::string("n_components_dense") };
+	inline static const auto number_components_amg{ std::string("n_components_amg") };
+	inline static const auto size_largest_component{ std::string("size_largest_component") };
+	inline static const auto number_threads{ std::string("n_threads") };
+	inline static const auto threads{ std::string("threads") };
+	inline static const auto factorization{ std::string("factorization") };
+	inline static const auto iterations{ std::string("iterations") };
+	inline static const auto residual{ std::string("residual") };
+	inline static const auto initial_state{ std::string("initial_state") };
+	inline static const auto source_target_set_ids{ std::string("source_ts_ids") };
 	inline static const auto size{ std::string("size") };
 	inline static const auto size_nodes{ std::string("size_nodes") };
 	inline static const auto size_edges{ std::string("size_edges") };
+	inline static const auto frozen{ std::string("frozen") };
+	inline static const auto strict{ std::string("strict") };
+	inline static const auto edge_allocations{ std::string("edge_allocations") };
+	inline static const auto arena_blocks{ std::string("arena_blocks") };
+	inline static const auto arena_bytes{ std::string("arena_bytes") };
 	inline static const auto time_run_checks{ std::string("time_run_checks") };
 	inline static const auto time_run_generator{ std::string("time_run_generator") };
 	inline static const auto time_total{ std::string("time_total") };
 	inline static const auto unit{ std::string("unit") };
 	inline static const auto milliseconds{ std::string("milliseconds") };
+	inline static const auto time_freeze{ std::string("time_freeze") };
+	inline static const auto time_dense_target_set{ std::string("time_dense_target_set") };
+	inline static const auto time_reduce_states{ std::string("time_reduce_states") };
 	inline static const auto time_create_pto_matrix{ std::string("time_create_pto_matrix") };
-	inline static const auto time_copy_pto_matrix{ std::string("time_copy_pto_matrix") };
-	inline static const auto time_subtract_unity_matrix{ std::string("time_subtract_unity_matrix") };
 	inline static const auto time_calc_image_vector{ std::string("time_calc_image_vector") };
+	inline static const auto time_prepare_linear_system{ std::string("time_prepare_linear_system") };
+	inline static const auto time_setup_solver{ std::string("time_setup_solver") };
+	inline static const auto solver_cache_hit{ std::string("solver_cache_hit") };
+	inline static const auto solver_parameters{ std::string("solver_parameters") };
 	inline static const auto time_solve_linear_system{ std::string("time_solve_linear_system") };
 	inline static const auto time_write_decoration_node{ std::string("time_write_decoration_node") };
-	inline static const auto time_calc_interim_reward{ std::string("time_calc_interim_reward") };
 	inline static const auto _expect{ std::string("_expect") };
 	inline static const auto _variance{ std::string("_variance") };
 	inline static const auto _covariance{ std::string("_covariance") };
@@ -0,0 +1,59 @@
+/**
+ * @file test.h
+ *
+ * Minimal checks for the test executables run by CTest.
+ *
+ */
+#pragma once
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+/**
+	@brief Counts failed checks of a test executable. main() returns \a test::result().
+*/
+struct test {
+
+	/// @brief Returns the number of failed checks so far.
+	static int& failures() {
+		static int n{ 0 };
+		return n;
+	}
+
+	/// @brief Reports a failed check if \a condition does not hold.
+	static void check(const bool& condition, const std::string& what, const char* file, const int& line) {
+		if (condition) return;
+		++failures();
+		std::cerr << file << ":" << line << ": check failed: " << what << std::endl;
+	}
+
+	/// @brief Returns true if and only if \a function throws an exception of type \a _Exception.
+	template<class _Exception, class _Function>
+	static bool throws(_Function&& function) {
+		try {
+			function();
+		}
+		catch (const _Exception&) {
+			return true;
+		}
+		catch (...) {
+		}
+		return false;
+	}
+
+	/// @brief Returns true if and only if \a a and \a b differ by at most \a tolerance relative to their magnitude, or are both infinite with the same sign, or are both NaN.
+	static bool near(const double& a, const double& b, const double& tolerance) {
+		if (std::isnan(a) || std::isnan(b)) return std::isnan(a) && std::isnan(b);
+		if (std::isinf(a) || std::isinf(b)) return a == b;
+		return std::abs(a - b) <= tolerance * std::max(1.0, std::max(std::abs(a), std::abs(b)));
+	}
+
+	/// @brief Returns the exit code of the test executable.
+	static int result() {
+		if (failures()) std::cerr << failures() << " check(s) failed." << std::endl;
+		return failures() ? 1 : 0;
+	}
+};
+
+#define CHECK(condition) test::check((condition), #condition, __FILE__, __LINE__)
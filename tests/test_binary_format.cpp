@@ -0,0 +1,120 @@
+#include "test.h"
+
+#include "../global_data.h"
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+using mc_type = global::mc_type;
+
+namespace {
+
+	std::vector<char> read_file(const std::string& file_path) {
+		std::ifstream file(file_path, std::ios_base::binary);
+		return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	void write_file(const std::string& file_path, const std::vector<char>& bytes) {
+		std::ofstream file(file_path, std::ios_base::binary);
+		file.write(bytes.data(), bytes.size());
+	}
+
+	/// @brief Recomputes the checksum at the end of \a bytes, like a snapshot edited on purpose.
+	void update_checksum(std::vector<char>& bytes) {
+		binary_format::checksum sum;
+		sum.add(bytes.data(), bytes.size() - sizeof(std::uint64_t));
+		const std::uint64_t checksum{ sum.value() };
+		std::memcpy(bytes.data() + bytes.size() - sizeof(checksum), &checksum, sizeof(checksum));
+	}
+
+	/// @brief Returns a pointer to column \a pos in the snapshot \a bytes of a markov chain with \a n_states states.
+	char* column_at(std::vector<char>& bytes, const std::size_t& n_states, const std::size_t& pos) {
+		return bytes.data() + sizeof(binary_format::header) + binary_format::padded((n_states + 1) * sizeof(std::uint64_t)) + pos * sizeof(global::int_type);
+	}
+
+	bool loads(const std::string& file_path) {
+		mc_type mc(0, 0);
+		mc.read_binary(file_path);
+		return true;
+	}
+
+}
+
+int main() {
+	// sparse ids 10, 20, 30, 40 with rewards and node decorations:
+	std::istringstream transitions("4 5\n10 20 0.5\n10 30 0.5\n20 40 1\n30 10 0.25\n30 40 0.75\n");
+	std::istringstream rewards("4 5\n10 20 1\n10 30 2\n20 40 3\n30 10 4\n30 40 5\n");
+	mc_type mc(1, 1);
+	mc.read_transitions_from_prism_file(transitions);
+	mc.read_rewards_from_prism_file(rewards, 0);
+	mc.set_decoration(std::vector<double>{ 1.5, 2.5, 3.5, 4.5 }, 0);
+
+	const std::string original_path{ "test_binary_format.bin" };
+	{
+		std::ofstream file(original_path, std::ios_base::binary);
+		mc.write_binary(file);
+	}
+
+	// round-trip: loading and saving again reproduces the same file
+	mc_type loaded(0, 0);
+	loaded.read_binary(original_path);
+	CHECK(loaded.frozen());
+	CHECK(loaded.size_states() == 4);
+	CHECK(loaded.size_edges() == 5);
+	CHECK(loaded.size_edge_decorations() == 1);
+	CHECK(loaded.size_node_decorations() == 1);
+	CHECK(loaded.state_id(3) == 40);
+	CHECK(loaded.dense_index(30) == 2);
+	CHECK(loaded.find_frozen_edge(30, 10) != loaded.size_edges());
+	CHECK(loaded.find_frozen_edge(10, 40) == loaded.size_edges());
+	{
+		std::ofstream file("test_binary_format_resaved.bin", std::ios_base::binary);
+		loaded.write_binary(file);
+	}
+	const auto bytes{ read_file(original_path) };
+	CHECK(read_file("test_binary_format_resaved.bin") == bytes);
+
+	// corrupted byte without updated checksum:
+	{
+		auto corrupted{ bytes };
+		corrupted[sizeof(binary_format::header)] ^= 1;
+		write_file("test_binary_format_corrupted.bin", corrupted);
+		CHECK(test::throws<std::invalid_argument>([] { loads("test_binary_format_corrupted.bin"); }));
+	}
+
+	// truncated file:
+	{
+		const std::vector<char> truncated(bytes.cbegin(), bytes.cend() - 16);
+		write_file("test_binary_format_truncated.bin", truncated);
+		CHECK(test::throws<std::invalid_argument>([] { loads("test_binary_format_truncated.bin"); }));
+	}
+
+	// transition to a non-existent state, checksum recomputed:
+	{
+		auto edited{ bytes };
+		const global::int_type column{ 4 };
+		std::memcpy(column_at(edited, 4, 2), &column, sizeof(column));
+		update_checksum(edited);
+		write_file("test_binary_format_column.bin", edited);
+		CHECK(test::throws<std::invalid_argument>([] { loads("test_binary_format_column.bin"); }));
+	}
+
+	// unsorted columns within the row of state 10 (dense index 0), checksum recomputed:
+	{
+		auto edited{ bytes };
+		std::vector<char> first(sizeof(global::int_type));
+		std::memcpy(first.data(), column_at(edited, 4, 0), first.size());
+		std::memcpy(column_at(edited, 4, 0), column_at(edited, 4, 1), first.size());
+		std::memcpy(column_at(edited, 4, 1), first.data(), first.size());
+		update_checksum(edited);
+		write_file("test_binary_format_unsorted.bin", edited);
+		CHECK(test::throws<std::invalid_argument>([] { loads("test_binary_format_unsorted.bin"); }));
+	}
+
+	// the unedited file still loads:
+	CHECK(loads(original_path));
+
+	return test::result();
+}
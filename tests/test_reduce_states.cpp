@@ -0,0 +1,82 @@
+#include "test.h"
+
+#include "../global_data.h"
+
+#include <sstream>
+
+using mc_type = global::mc_type;
+
+int main() {
+	// 3 is the target. 0 and 1 reach it almost surely, 5 only via 0.
+	// 2 and 4 never reach it, 6 reaches it with probability 0.5 only.
+	std::istringstream transitions(
+		"7 10\n"
+		"0 1 0.5\n0 3 0.5\n"
+		"1 0 0.5\n1 3 0.5\n"
+		"2 4 1\n"
+		"3 3 1\n"
+		"4 4 1\n"
+		"5 0 1\n"
+		"6 2 0.5\n6 3 0.5\n");
+	mc_type mc(1, 1);
+	mc.read_transitions_from_prism_file(transitions);
+	mc.freeze();
+	global::set_type target;
+	target.insert(3);
+	const auto dense_target{ mc.dense_state_set(target) };
+
+	{
+		const auto reduction{ reduce_states(mc, dense_target, std::nullopt) };
+		CHECK(reduction.n_target == 1);
+		CHECK(reduction.n_infinite == 3);
+		CHECK(reduction.n_unreachable == 0);
+		CHECK((reduction.kept == std::vector<std::size_t>{ 0, 1, 5 }));
+		CHECK(reduction.reduced_index[5] == 2);
+		CHECK(reduction.reduced_index[3] == state_reduction::npos);
+		CHECK(reduction.excluded_values[3] == 0);
+		for (const std::size_t state : { 2, 4, 6 }) {
+			CHECK(reduction.reduced_index[state] == state_reduction::npos);
+			CHECK(std::isinf(reduction.excluded_values[state]));
+		}
+
+		// P - I restricted to the kept states, transitions into the target are dropped:
+		const auto m{ reduced_system_matrix(mc, reduction) };
+		CHECK(m.size_m() == 3);
+		CHECK(m.size_n() == 3);
+		CHECK(m.nonzeros() == 6);
+		CHECK(m(0, 0) == -1);
+		CHECK(m(0, 1) == 0.5);
+		CHECK(m(1, 0) == 0.5);
+		CHECK(m(1, 1) == -1);
+		CHECK(m(2, 0) == 1);
+		CHECK(m(2, 2) == -1);
+		CHECK(m(0, 2) == 0);
+
+		CHECK(test::near(reduction.expand({ 1, 2, 3 })[5], 3, 0));
+		CHECK(std::isinf(reduction.expand({ 1, 2, 3 })[6]));
+		CHECK((reduction.restrict({ 10, 11, 12, 13, 14, 15, 16 }) == std::vector<double>{ 10, 11, 15 }));
+	}
+
+	{
+		// from initial state 0, state 5 is unreachable:
+		const auto reduction{ reduce_states(mc, dense_target, std::optional<std::size_t>(0)) };
+		CHECK(reduction.n_target == 1);
+		CHECK(reduction.n_infinite == 3);
+		CHECK(reduction.n_unreachable == 1);
+		CHECK((reduction.kept == std::vector<std::size_t>{ 0, 1 }));
+		CHECK(std::isnan(reduction.excluded_values[5]));
+	}
+
+	{
+		// with state 3 and 4 both targets, 2 reaches the target almost surely and 6 as well:
+		global::set_type targets;
+		targets.insert(3);
+		targets.insert(4);
+		const auto reduction{ reduce_states(mc, mc.dense_state_set(targets), std::nullopt) };
+		CHECK(reduction.n_target == 2);
+		CHECK(reduction.n_infinite == 0);
+		CHECK((reduction.kept == std::vector<std::size_t>{ 0, 1, 2, 5, 6 }));
+	}
+
+	return test::result();
+}
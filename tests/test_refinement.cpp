@@ -0,0 +1,120 @@
+#include "test.h"
+
+#include "../global_data.h"
+
+#include <sstream>
+
+using mc_type = global::mc_type;
+
+namespace {
+
+	/// @brief Returns ||b - M * x|| / ||b||, calculated in double.
+	double relative_residual(const sparse_matrix& M, const std::vector<double>& x, const std::vector<double>& b) {
+		double norm_r{ 0 }, norm_b{ 0 };
+		for (std::size_t i{ 0 }; i < b.size(); ++i) {
+			double r{ b[i] };
+			for (auto pos{ M.row_begin(static_cast<sparse_matrix::index_type>(i)) }; pos != M.row_end(static_cast<sparse_matrix::index_type>(i)); ++pos)
+				r -= M.value(pos) * x[static_cast<std::size_t>(M.column(pos))];
+			norm_r += r * r;
+			norm_b += b[i] * b[i];
+		}
+		return std::sqrt(norm_r / norm_b);
+	}
+
+	solver_parameters parameters(const std::vector<std::pair<std::string, std::string>>& pairs) {
+		solver_parameters prm{ default_solver_parameters() };
+		prm.put("engine", "amg");
+		for (const auto& pair : pairs) prm.put(pair.first, pair.second);
+		return prm;
+	}
+
+}
+
+int main() {
+	// a ring of 3000 states with shortcuts, leaving to target 3000 with probability 0.05 per step, and rewards of different magnitudes:
+	const std::size_t n{ 3000 };
+	std::ostringstream text;
+	text << n + 1 << " " << 3 * n + 1 << "\n";
+	for (std::size_t i{ 0 }; i < n; ++i) {
+		const std::size_t next{ (i + 1) % n }, jump{ (i + 97) % n };
+		text << i << " " << std::min(next, jump) << " " << (next < jump ? 0.65 : 0.3) << "\n";
+		text << i << " " << std::max(next, jump) << " " << (next < jump ? 0.3 : 0.65) << "\n";
+		text << i << " " << n << " " << 0.05 << "\n";
+	}
+	text << n << " " << n << " 1\n";
+	std::istringstream transitions(text.str());
+	mc_type mc(0, 0);
+	mc.read_transitions_from_prism_file(transitions);
+	global::set_type target;
+	target.insert(static_cast<global::int_type>(n));
+	const auto reduction{ reduce_states(mc, mc.dense_state_set(target), std::nullopt) };
+	const auto matrix{ reduced_system_matrix(mc, reduction) };
+	std::vector<double> b(reduction.kept.size());
+	for (std::size_t i{ 0 }; i < b.size(); ++i) b[i] = -1.0 - static_cast<double>(i % 7) * 1000.0;
+
+	const auto reference{ (*make_solver_engine(matrix, parameters({ { "engine", "direct" } })))(b) };
+
+	{
+		// mixed precision reaches the double tolerance:
+		const auto engine{ make_solver_engine(matrix, parameters({ { "precision", "mixed" }, { "refinement.tol", "1e-12" } })) };
+		const auto x{ (*engine)(b) };
+		CHECK(relative_residual(matrix, x, b) <= 1e-12);
+		const nlohmann::json statistics = engine->solve_statistics();
+		CHECK(statistics[sc::residual].get<double>() <= 1e-12);
+		bool agree{ true };
+		for (std::size_t i{ 0 }; i < x.size(); ++i) agree = agree && test::near(x[i], reference[i], 1e-9);
+		CHECK(agree);
+	}
+
+	{
+		// a single step only gets as far as the inner single precision solve, the residual reported is the true one:
+		const auto engine{ make_solver_engine(matrix, parameters({ { "precision", "mixed" }, { "refinement.tol", "1e-12" }, { "refinement.maxiter", "1" } })) };
+		const auto x{ (*engine)(b) };
+		const nlohmann::json statistics = engine->solve_statistics();
+		CHECK(statistics[sc::residual].get<double>() > 1e-12);
+		CHECK(test::near(statistics[sc::residual].get<double>(), relative_residual(matrix, x, b), 1e-6));
+	}
+
+	{
+		// an unreachable tolerance stops at stagnation, without getting worse:
+		const auto engine{ make_solver_engine(matrix, parameters({ { "precision", "mixed" }, { "refinement.tol", "0" } })) };
+		const auto x{ (*engine)(b) };
+		CHECK(relative_residual(matrix, x, b) <= 1e-12);
+	}
+
+	{
+		// values beyond the range of float make the inner solves fail, refinement keeps the last iterate that reduced the residual and reports its residual:
+		const sparse_matrix::index_type size{ 500 };
+		sparse_matrix scaled(size, size, 3 * static_cast<std::size_t>(size));
+		for (sparse_matrix::index_type i{ 0 }; i < size; ++i) {
+			const double factor{ i == 0 ? 1e39 : 1.0 };
+			if (i > 0) scaled.push_back(i - 1, -0.45 * factor);
+			scaled.push_back(i, factor);
+			if (i + 1 < size) scaled.push_back(i + 1, -0.45 * factor);
+			scaled.end_row();
+		}
+		std::vector<double> scaled_b(static_cast<std::size_t>(size), -1.0);
+		scaled_b[0] *= 1e39;
+		const auto engine{ make_solver_engine(scaled, parameters({ { "precision", "mixed" }, { "refinement.tol", "1e-12" } })) };
+		const auto x{ (*engine)(scaled_b) };
+		bool finite{ true };
+		for (const auto& value : x) finite = finite && std::isfinite(value);
+		CHECK(finite);
+		const nlohmann::json statistics = engine->solve_statistics();
+		const double residual{ statistics[sc::residual].get<double>() };
+		CHECK(std::isfinite(residual) && residual > 1e-12);
+		CHECK(test::near(residual, relative_residual(scaled, x, scaled_b), 1e-6));
+	}
+
+	{
+		// single precision results are accurate to about the tolerance of the single precision solve:
+		const auto x{ (*make_solver_engine(matrix, parameters({ { "precision", "single" }, { "solver.tol", "1e-5" } })))(b) };
+		bool agree{ true };
+		for (std::size_t i{ 0 }; i < x.size(); ++i) agree = agree && test::near(x[i], reference[i], 1e-3);
+		CHECK(agree);
+	}
+
+	CHECK(test::throws<std::invalid_argument>([&] { make_solver_engine(matrix, parameters({ { "precision", "half" } })); }));
+
+	return test::result();
+}
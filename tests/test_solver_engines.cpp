@@ -0,0 +1,111 @@
+#include "test.h"
+
+#include "../global_data.h"
+
+#include <sstream>
+
+using mc_type = global::mc_type;
+
+namespace {
+
+	/**
+		@brief Returns a .tra file of a markov chain in which all states reach target state 1500 almost surely.
+		@details States 0 ... 999 form one big strongly connected component, states 1000 ... 1299 form 100 cycles of 3 states each,
+		states 1300 ... 1499 form an acyclic path.
+	*/
+	std::string model() {
+		std::vector<std::string> lines;
+		const auto add = [&](const std::size_t& from, const std::size_t& to, const double& p) {
+			std::ostringstream line;
+			line << from << " " << to << " " << p;
+			lines.push_back(line.str());
+		};
+		const std::size_t target{ 1500 };
+		for (std::size_t i{ 0 }; i < 1000; ++i) {
+			const std::size_t next{ (i + 1) % 1000 }, jump{ (i * 7 + 3) % 1000 };
+			if (next == jump) add(i, next, 0.9);
+			else if (next < jump) {
+				add(i, next, 0.6);
+				add(i, jump, 0.3);
+			}
+			else {
+				add(i, jump, 0.3);
+				add(i, next, 0.6);
+			}
+			add(i, target, 0.1);
+		}
+		for (std::size_t k{ 0 }; k < 100; ++k) {
+			const std::size_t first{ 1000 + 3 * k };
+			for (std::size_t i{ 0 }; i < 3; ++i) {
+				add(first + i, (k * 13) % 1000, 0.4);
+				add(first + i, first + (i + 1) % 3, 0.5);
+				add(first + i, target, 0.1);
+			}
+		}
+		for (std::size_t j{ 0 }; j < 200; ++j) {
+			add(1300 + j, 1000 + j % 300, 0.5);
+			add(1300 + j, j + 1 < 200 ? 1300 + j + 1 : target, 0.5);
+		}
+		add(target, target, 1);
+		std::ostringstream result;
+		result << target + 1 << " " << lines.size() << "\n";
+		for (const auto& line : lines) result << line << "\n";
+		return result.str();
+	}
+
+	solver_parameters parameters(const std::vector<std::pair<std::string, std::string>>& pairs) {
+		solver_parameters prm{ default_solver_parameters() };
+		prm.put("solver.tol", "1e-12");
+		prm.put("iteration.tol", "1e-12");
+		for (const auto& pair : pairs) prm.put(pair.first, pair.second);
+		return prm;
+	}
+
+}
+
+int main() {
+	std::istringstream transitions(model());
+	mc_type mc(1, 1);
+	mc.read_transitions_from_prism_file(transitions);
+	mc.freeze();
+	global::set_type target;
+	target.insert(1500);
+	const auto reduction{ reduce_states(mc, mc.dense_state_set(target), std::nullopt) };
+	CHECK(reduction.kept.size() == 1500);
+	const auto matrix{ reduced_system_matrix(mc, reduction) };
+	const std::vector<double> b(reduction.kept.size(), -1.0); // expected number of steps
+
+	// reference: dense LU on the whole system
+	const auto reference{ (*make_solver_engine(matrix, parameters({ { "engine", "direct" }, { "direct.dense_max", "2000" } })))(b) };
+	for (std::size_t i{ 0 }; i < 1000; ++i) CHECK(test::near(reference[i], 10, 1e-9)); // leaves the big component with probability 0.1 per step only to the target
+
+	const std::vector<std::vector<std::pair<std::string, std::string>>> configurations{
+		{ { "engine", "auto" } },
+		{ { "engine", "direct" } },
+		{ { "engine", "amg" } },
+		{ { "engine", "scc" } },
+		{ { "engine", "scc" }, { "scc.dense_max", "0" } },
+		{ { "engine", "jacobi" } },
+		{ { "engine", "gauss_seidel" } },
+		{ { "engine", "interval" } },
+		{ { "engine", "interval" }, { "iteration.criterion", "absolute" } }
+	};
+	for (const auto& configuration : configurations) {
+		const auto engine{ make_solver_engine(matrix, parameters(configuration)) };
+		const auto x{ (*engine)(b) };
+		bool agree{ x.size() == reference.size() };
+		for (std::size_t i{ 0 }; agree && i < x.size(); ++i) agree = test::near(x[i], reference[i], 1e-8);
+		test::check(agree, "engine " + solver_parameters_to_json(parameters(configuration)).dump() + " agrees with dense LU", __FILE__, __LINE__);
+	}
+
+	// the scc engine solves all three kinds of components:
+	const nlohmann::json scc_statistics = make_solver_engine(matrix, parameters({ { "engine", "scc" } }))->statistics();
+	CHECK(scc_statistics[sc::number_components_amg] == 1);
+	CHECK(scc_statistics[sc::number_components_dense] == 100);
+	CHECK(scc_statistics[sc::number_components_trivial] == 200);
+	CHECK(scc_statistics[sc::size_largest_component] == 1000);
+
+	CHECK(test::throws<std::invalid_argument>([&] { make_solver_engine(matrix, parameters({ { "engine", "unknown" } })); }));
+
+	return test::result();
+}
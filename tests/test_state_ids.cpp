@@ -0,0 +1,104 @@
+#include "test.h"
+
+#include "../global_data.h"
+#include "../mc_calc.h"
+
+#include <map>
+#include <sstream>
+
+using mc_type = global::mc_type;
+
+namespace {
+
+	/// @brief Returns the first node decoration of each state id, as written by \a markov_chain::write_edge_decorations.
+	std::map<global::int_type, double> node_decorations(mc_type& mc) {
+		std::ostringstream output;
+		output.precision(17);
+		mc.write_edge_decorations(output);
+		std::istringstream input(output.str());
+		std::map<global::int_type, double> result;
+		global::int_type id;
+		char colon;
+		std::string value;
+		while (input >> id >> colon >> value) result[id] = std::stod(value);
+		return result;
+	}
+
+}
+
+int main() {
+	{
+		// sparse ids not starting at 0, 1000 is the target:
+		std::istringstream transitions("4 6\n5 7 0.5\n5 100 0.5\n7 1000 1\n100 5 0.5\n100 1000 0.5\n1000 1000 1\n");
+		std::istringstream rewards("4 5\n5 7 1\n5 100 1\n7 1000 1\n100 5 1\n100 1000 1\n");
+		mc_type mc(1, 1);
+		mc.read_transitions_from_prism_file(transitions);
+		mc.read_rewards_from_prism_file(rewards, 0);
+		CHECK(mc.frozen());
+		mc.freeze(); // no effect on a frozen markov chain
+		CHECK(mc.size_states() == 4);
+		CHECK(mc.size_edges() == 6);
+		CHECK(mc.state_id(0) == 5);
+		CHECK(mc.state_id(1) == 7);
+		CHECK(mc.state_id(2) == 100);
+		CHECK(mc.state_id(3) == 1000);
+		CHECK(mc.dense_index(100) == 2);
+		CHECK(mc.dense_index(6) == mc.size_states());
+		CHECK(mc.dense_index(0) == mc.size_states());
+		CHECK(mc.dense_index(2000) == mc.size_states());
+		CHECK(mc.find_frozen_edge(100, 5) != mc.size_edges());
+		CHECK(mc.find_frozen_edge(7, 5) == mc.size_edges());
+
+		global::set_type ids;
+		ids.insert(7);
+		ids.insert(1000);
+		ids.insert(3); // no such state
+		global::set_type dense;
+		dense.insert(1);
+		dense.insert(3);
+		CHECK(mc.dense_state_set(ids) == dense);
+		CHECK(mc.state_id_set().size() == 4);
+		CHECK(mc.state_id_set().count(100) == 1);
+
+		// expected number of steps until 1000, results are written by state id:
+		global::set_type target;
+		target.insert(1000);
+		std::shared_ptr<prepared_linear_system> system;
+		calc_expect(mc, 0, target, 0, system);
+		const auto values{ node_decorations(mc) };
+		CHECK(values.size() == 4);
+		CHECK(test::near(values.at(5), 8.0 / 3.0, 1e-9));
+		CHECK(test::near(values.at(7), 1, 1e-9));
+		CHECK(test::near(values.at(100), 7.0 / 3.0, 1e-9));
+		CHECK(test::near(values.at(1000), 0, 1e-9));
+	}
+
+	{
+		// contiguous ids 0 ... n-1 need no translation table:
+		std::istringstream transitions("3 3\n0 1 1\n1 2 1\n2 2 1\n");
+		mc_type mc(0, 0);
+		mc.read_transitions_from_prism_file(transitions);
+		CHECK(mc.size_states() == 3);
+		CHECK(mc.dense_index(2) == 2);
+		CHECK(mc.dense_index(3) == 3);
+		CHECK(mc.state_id(1) == 1);
+	}
+
+	{
+		// a reward for a transition that does not exist is rejected:
+		std::istringstream transitions("2 2\n10 20 1\n20 20 1\n");
+		std::istringstream rewards("2 1\n20 10 1\n");
+		mc_type mc(1, 0);
+		mc.read_transitions_from_prism_file(transitions);
+		CHECK(test::throws<std::invalid_argument>([&] { mc.read_rewards_from_prism_file(rewards, 0); }));
+	}
+
+	{
+		// duplicate transitions are rejected:
+		std::istringstream transitions("2 3\n10 20 0.5\n10 20 0.5\n20 20 1\n");
+		mc_type mc(0, 0);
+		CHECK(test::throws<std::invalid_argument>([&] { mc.read_transitions_from_prism_file(transitions); }));
+	}
+
+	return test::result();
+}
@@ -0,0 +1,169 @@
+/**
+ * @file tokenizer.h
+ *
+ * Hand-written line-oriented tokenizer for numeric text input.
+ *
+ */
+#pragma once
+
+#include <charconv>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/**
+	@brief Walks through a character range token by token, e.g. a memory-mapped input file.
+	@details Tokens are separated by blanks (spaces and tabs) or commas, lines by "\n", "\r\n" or "\r".
+	Numbers are parsed in place using std::from_chars, nothing is copied.
+	The cursor may work on a part of a bigger range (e.g. one chunk of a file parsed in parallel), line numbers are still counted from the \a origin of the whole range.
+*/
+class text_cursor {
+	const char* origin;
+	const char* pos;
+	const char* last;
+
+	static bool is_blank(const char& c) noexcept { return c == ' ' || c == '\t' || c == '\v' || c == '\f'; }
+	static bool is_line_break(const char& c) noexcept { return c == '\n' || c == '\r'; }
+	static bool is_separator(const char& c) noexcept { return c == ','; }
+
+	/// @brief Returns a pointer behind the token starting at \a pos.
+	const char* token_end() const noexcept {
+		const char* it{ pos };
+		while (it != last && !is_blank(*it) && !is_line_break(*it) && !is_separator(*it)) ++it;
+		return it;
+	}
+
+public:
+	/// @brief Creates a cursor pointing to \a first, parsing the range [ \a first, \a last ).
+	text_cursor(const char* first, const char* last) noexcept : origin(first), pos(first), last(last) {}
+
+	/// @brief Creates a cursor pointing to \a first, parsing the range [ \a first, \a last ) which is part of a bigger range starting at \a origin.
+	text_cursor(const char* origin, const char* first, const char* last) noexcept : origin(origin), pos(first), last(last) {}
+
+	/// @brief Returns true if and only if the whole range has been consumed.
+	bool at_end() const noexcept { return pos == last; }
+
+	/// @brief Returns true if and only if the cursor points to a line break or to the end of the range.
+	bool at_line_end() const noexcept { return pos == last || is_line_break(*pos); }
+
+	/**
+		@brief Returns the number of the current line, starting with 1.
+		@details Line breaks are counted from \a origin on each call, so use this for error messages only.
+	*/
+	std::size_t line_number() const noexcept {
+		std::size_t line{ 1 };
+		for (const char* it{ origin }; it != pos; ++it)
+			if (*it == '\n' || (*it == '\r' && (it + 1 == pos || *(it + 1) != '\n'))) ++line;
+		return line;
+	}
+
+	/// @brief Returns a pointer to the current position.
+	const char* position() const noexcept { return pos; }
+
+	/// @brief Skips blanks within the current line.
+	void skip_blanks() noexcept {
+		while (pos != last && is_blank(*pos)) ++pos;
+	}
+
+	/// @brief Skips blanks and line breaks.
+	void skip_whitespace() noexcept {
+		while (pos != last) {
+			if (is_blank(*pos)) ++pos;
+			else if (is_line_break(*pos)) skip_line_break();
+			else return;
+		}
+	}
+
+	/// @brief Consumes one line break if the cursor points to one.
+	void skip_line_break() noexcept {
+		if (pos == last) return;
+		if (*pos == '\r') {
+			++pos;
+			if (pos != last && *pos == '\n') ++pos;
+		}
+		else if (*pos == '\n') {
+			++pos;
+		}
+	}
+
+	/// @brief Returns true if and only if the cursor points to character \a c.
+	bool peek(const char& c) const noexcept { return pos != last && *pos == c; }
+
+	/// @brief Skips blanks and consumes character \a c if the cursor points to it. Returns true if and only if \a c was consumed.
+	bool consume(const char& c) noexcept {
+		skip_blanks();
+		if (!peek(c)) return false;
+		++pos;
+		return true;
+	}
+
+	/// @brief Skips blanks and returns the next token, which is empty if the cursor points to a line end or a separator.
+	std::string read_token() {
+		skip_blanks();
+		const char* begin{ pos };
+		pos = token_end();
+		return std::string(begin, pos);
+	}
+
+	/// @brief Skips everything up to and including the next line break.
+	void skip_line() noexcept {
+		while (!at_line_end()) ++pos;
+		skip_line_break();
+	}
+
+	/**
+		@brief Skips blanks and reads a token that is a non-negative integer into \a value.
+		@details Returns false, leaving the cursor behind the blanks, if there is no such token or it does not fit into \a _IntegralT.
+	*/
+	template<class _IntegralT>
+	bool read_unsigned(_IntegralT& value) noexcept {
+		skip_blanks();
+		const char* end{ token_end() };
+		if (pos == end) return false;
+		const auto result{ std::from_chars(pos, end, value) };
+		if (result.ec != std::errc() || result.ptr != end) return false;
+		pos = end;
+		return true;
+	}
+
+	/**
+		@brief Skips blanks and reads a token that is a floating point number (optionally signed, optionally with exponent) into \a value.
+		@details Returns false, leaving the cursor behind the blanks, if there is no such token.
+	*/
+	bool read_float(double& value) {
+		skip_blanks();
+		const char* end{ token_end() };
+		const char* begin{ pos };
+		if (begin != end && *begin == '+') ++begin; // std::from_chars does not accept a leading plus
+		if (begin == end) return false;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+		const auto result{ std::from_chars(begin, end, value) };
+		if (result.ec != std::errc() || result.ptr != end) return false;
+#else
+		// no floating point std::from_chars, fall back to strtod on a null-terminated copy of the token
+		const std::string token(begin, end);
+		char* parsed_end{ nullptr };
+		value = std::strtod(token.c_str(), &parsed_end);
+		if (parsed_end != token.c_str() + token.size()) return false;
+#endif
+		pos = end;
+		return true;
+	}
+};
+
+/**
+	@brief Splits [ \a first, \a last ) into at most \a n_chunks parts of similar size whose boundaries are at beginnings of lines.
+	@details Returns the boundaries, i.e. chunk i is [ result[i], result[i+1] ). Empty chunks are dropped.
+*/
+inline std::vector<const char*> split_into_line_chunks(const char* first, const char* last, const std::size_t& n_chunks) {
+	std::vector<const char*> boundaries{ first };
+	const std::size_t size{ static_cast<std::size_t>(last - first) };
+	for (std::size_t i{ 1 }; i < n_chunks; ++i) {
+		const char* it{ first + size / n_chunks * i };
+		if (it <= boundaries.back()) continue;
+		while (it != last && *(it - 1) != '\n') ++it;
+		if (it != last && it != boundaries.back()) boundaries.push_back(it);
+	}
+	if (first != last) boundaries.push_back(last);
+	return boundaries;
+}